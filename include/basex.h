@@ -22,6 +22,13 @@ typedef struct {
     bool has_bmi1;
     bool has_bmi2;
     char cpu_name[64];
+    /* New fields go after cpu_name; the struct grew in soversion 2 */
+    bool has_avx512f;
+    bool has_avx512bw;
+    bool has_avx512vl;
+    bool has_avx512vbmi;
+    bool has_ssse3;
+    bool has_sse41;
 } basex_cpu_features_t;
 
 /**
@@ -35,6 +42,32 @@ basex_cpu_features_t basex_detect_cpu_features(void);
  */
 void basex_print_cpu_info(void);
 
+/* Kernel tiers, selected once at runtime */
+typedef enum {
+    BASEX_ISA_PORTABLE = 0,
+    BASEX_ISA_BMI2,
+    BASEX_ISA_SSE41,
+    BASEX_ISA_AVX2,
+    BASEX_ISA_AVX512VBMI,
+    BASEX_ISA_COUNT
+} basex_isa_t;
+
+/**
+ * Get the kernel tier used by the encoders/decoders.
+ * The best tier supported by the CPU and OS is chosen on first use;
+ * the BASEX_FORCE_ISA environment variable (e.g. "portable") can
+ * select a lower tier, for benchmarking.
+ * @return Active kernel tier
+ */
+basex_isa_t basex_active_isa(void);
+
+/**
+ * Get the name of a kernel tier
+ * @param isa Kernel tier
+ * @return Tier name as accepted by BASEX_FORCE_ISA (e.g. "avx2")
+ */
+const char* basex_isa_name(basex_isa_t isa);
+
 /* Base32 encoding/decoding */
 
 /**
@@ -205,6 +238,234 @@ ssize_t basex_base122_encode(const uint8_t* input, size_t input_len, char* outpu
  */
 ssize_t basex_base122_decode(const char* input, size_t input_len, uint8_t* output);
 
+/* Streaming encoding/decoding */
+
+/* Codecs available through the streaming API */
+typedef enum {
+    BASEX_CODEC_BASE32 = 0,
+    BASEX_CODEC_BASE64,
+    BASEX_CODEC_BASE85,
+    BASEX_CODEC_BASE91,
+    BASEX_CODEC_BASE122
+} basex_codec_t;
+
+/* Bytes outside the alphabet when stream decoding */
+typedef enum {
+    BASEX_SKIP_DEFAULT = 0, /* As the one-shot decoders: Base32/Base64 skip them,
+                               Base85/Base91 reject them, Base122 takes any byte */
+    BASEX_SKIP_WHITESPACE,  /* Skip whitespace, reject any other byte */
+    BASEX_SKIP_GARBAGE      /* Skip every byte outside the alphabet */
+} basex_skip_t;
+
+/*
+ * Streaming state. Input may be split anywhere; the concatenated output
+ * of all updates and the final call equals the one-shot result for the
+ * concatenated input. Fields are internal, set up with basex_stream_init().
+ */
+typedef struct {
+    basex_codec_t codec;
+    bool decode;
+    basex_skip_t skip;      /* Decoder: bytes outside the alphabet */
+    bool done;              /* Decoder reached padding, rest is ignored */
+    uint64_t accumulator;   /* Bits not written yet */
+    unsigned bits;
+    int pending;            /* Base91 decode: open half of a pair, or -1 */
+    bool escaped;           /* Base122 decode: last byte was an escape */
+    uint8_t carry[8];       /* Incomplete block held for the next call */
+    size_t carry_len;
+    unsigned wrap;          /* Encoder: line length, 0 for one line */
+    bool crlf;              /* Encoder: end lines with CRLF instead of LF */
+    unsigned column;        /* Encoder: characters on the current line */
+} basex_stream_t;
+
+/**
+ * Initialize a streaming encoder or decoder
+ * @param stream State to initialize
+ * @param codec Codec to use
+ * @param decode true to decode, false to encode
+ * @return 0 on success, -1 on invalid arguments
+ */
+int basex_stream_init(basex_stream_t* stream, basex_codec_t codec, bool decode);
+
+/**
+ * Choose how a decoding stream treats bytes outside the alphabet.
+ * Skippable bytes are compacted out in L1-sized pieces just ahead of
+ * the decoder, so wrapped input needs no whole-buffer filtering pass.
+ * @param stream Initialized decoding stream
+ * @param skip Skip mode (BASEX_SKIP_DEFAULT after basex_stream_init)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int basex_stream_set_skip(basex_stream_t* stream, basex_skip_t skip);
+
+/**
+ * Break the output of an encoding stream into lines. Line breaks are
+ * written into the output buffer along with the encoded text, and the
+ * final call ends a partial last line with one as well.
+ * @param stream Initialized encoding stream, before the first update
+ * @param columns Characters per line, 0 for no line breaks (default)
+ * @param crlf true to end lines with CRLF instead of LF
+ * @return 0 on success, -1 on invalid arguments
+ */
+int basex_stream_set_wrap(basex_stream_t* stream, unsigned columns, bool crlf);
+
+/**
+ * Calculate a buffer size large enough for one update or final call
+ * @param stream Initialized stream
+ * @param input_len Length of the input passed to the update (0 for final)
+ * @return Required output buffer size in bytes
+ */
+size_t basex_stream_output_len(const basex_stream_t* stream, size_t input_len);
+
+/**
+ * Encode or decode the next piece of input
+ * @param stream Initialized stream
+ * @param input Input data (bytes to encode or characters to decode)
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_stream_output_len)
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_stream_update(basex_stream_t* stream, const void* input, size_t input_len,
+                            void* output);
+
+/**
+ * Flush held-back input and padding at end of stream
+ * @param stream Initialized stream; it must be re-initialized for reuse
+ * @param output Output buffer (see basex_stream_output_len)
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_stream_final(basex_stream_t* stream, void* output);
+
+/* Parallel encoding/decoding */
+
+/*
+ * Large buffers are split into pieces that are coded on several threads
+ * (block codecs on block boundaries, Base91/Base122 decoding at bit
+ * offsets found in a counting pass). Output is identical to the one-shot
+ * functions and uses the same buffer sizes. threads is the number of
+ * threads to use, 0 for one per online CPU; inputs too small to be worth
+ * splitting run on the calling thread.
+ */
+
+/**
+ * Encode data to Base32 using several threads
+ * @param input Input data buffer
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_base32_encode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base32_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads);
+
+/**
+ * Decode Base32 data using several threads
+ * Line breaks and other skipped characters may fall anywhere.
+ * @param input Input Base32 string
+ * @param input_len Input string length
+ * @param output Output buffer (see basex_base32_decode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base32_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads);
+
+/**
+ * Encode data to Base64 using several threads
+ * @param input Input data buffer
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_base64_encode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base64_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads);
+
+/**
+ * Decode Base64 data using several threads
+ * Line breaks and other skipped characters may fall anywhere.
+ * @param input Input Base64 string
+ * @param input_len Input string length
+ * @param output Output buffer (see basex_base64_decode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base64_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads);
+
+/**
+ * Encode data to Base85 using several threads
+ * @param input Input data buffer
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_base85_encode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base85_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads);
+
+/**
+ * Decode Base85 data using several threads
+ * Like basex_base85_decode(), the input must not contain whitespace.
+ * @param input Input Base85 string
+ * @param input_len Input string length
+ * @param output Output buffer (see basex_base85_decode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base85_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads);
+
+/**
+ * Encode data to Base122 using several threads (7-byte blocks)
+ * @param input Input data buffer
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_base122_encode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base122_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                      int threads);
+
+/**
+ * Decode Base91 data using several threads
+ * Pairs carry 13 or 14 bits, so the bits of each piece are counted first
+ * to find where its output starts.
+ * @param input Input Base91 string
+ * @param input_len Input string length
+ * @param output Output buffer (see basex_base91_decode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base91_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads);
+
+/**
+ * Decode Base122 data using several threads
+ * Escape markers carry no bits, so the values of each piece are counted
+ * first to find where its output starts.
+ * @param input Input Base122 string
+ * @param input_len Input string length
+ * @param output Output buffer (see basex_base122_decode_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_base122_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                      int threads);
+
+/**
+ * Like basex_stream_update(), but large inputs are split across threads
+ * where the codec allows it: block codecs, and Base91/Base122 decoding.
+ * Other streams are updated on the calling thread. Output is identical.
+ * @param stream Initialized stream
+ * @param input Input data (bytes to encode or characters to decode)
+ * @param input_len Input data length
+ * @param output Output buffer (see basex_stream_output_len)
+ * @param threads Number of threads, 0 for all CPUs
+ * @return Number of bytes written, or -1 on error
+ */
+ssize_t basex_stream_update_parallel(basex_stream_t* stream, const void* input, size_t input_len,
+                                     void* output, int threads);
+
 /* Common utilities */
 
 /**
@@ -1,12 +1,19 @@
+#define _POSIX_C_SOURCE 200809L
 #include "../../include/basex.h"
+#include "input.h"
+#include "output.h"
+#include "uring.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <getopt.h>
 #include <unistd.h>
-#include <ctype.h>
+#include <sys/mman.h>
 
 #define BUFFER_SIZE (64 * 1024)
+#define PARALLEL_BUFFER_SIZE (16 * 1024 * 1024)
+#define URING_BUFFER_SIZE (1024 * 1024)
 
 static void print_usage(const char* progname) {
     printf("Usage: %s [OPTION]... [FILE]\n", progname);
@@ -15,6 +22,8 @@ static void print_usage(const char* progname) {
     printf("  -w, --wrap=COLS       wrap encoded lines after COLS characters (default 76)\n");
     printf("                        use 0 to disable line wrapping\n");
     printf("  -i, --ignore-garbage  when decoding, ignore non-alphabet characters\n");
+    printf("  -T, --threads=NUM     decode on NUM threads (default 1, 0 = all CPUs)\n");
+    printf("  -U, --io-uring        read and write through io_uring, report MB/s\n");
     printf("      --cpu-info        show CPU features and exit\n");
     printf("      --help            display this help and exit\n");
     printf("      --version         output version information and exit\n\n");
@@ -31,12 +40,16 @@ int main(int argc, char* argv[]) {
     bool decode = false;
     int wrap_cols = 76;
     bool ignore_garbage = false;
+    int threads = 1;
+    bool use_uring = false;
     const char* filename = NULL;
     
     static struct option long_options[] = {
         {"decode", no_argument, 0, 'd'},
         {"wrap", required_argument, 0, 'w'},
         {"ignore-garbage", no_argument, 0, 'i'},
+        {"threads", required_argument, 0, 'T'},
+        {"io-uring", no_argument, 0, 'U'},
         {"cpu-info", no_argument, 0, 'c'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -44,7 +57,7 @@ int main(int argc, char* argv[]) {
     };
     
     int opt;
-    while ((opt = getopt_long(argc, argv, "dw:i", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "dw:iT:U", long_options, NULL)) != -1) {
         switch (opt) {
             case 'd':
                 decode = true;
@@ -55,6 +68,16 @@ int main(int argc, char* argv[]) {
             case 'i':
                 ignore_garbage = true;
                 break;
+            case 'T':
+                threads = atoi(optarg);
+                if (threads < 0) {
+                    fprintf(stderr, "Invalid thread count: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'U':
+                use_uring = true;
+                break;
             case 'c':
                 basex_print_cpu_info();
                 return 0;
@@ -83,79 +106,98 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    uint8_t* in_buffer = malloc(BUFFER_SIZE);
-    char* out_buffer = malloc(BUFFER_SIZE * 2);
+    // Chunks may split a block or pair anywhere; the stream carries it over.
+    // Threads share a chunk, so they get larger ones.
+    size_t buffer_size = threads != 1 ? PARALLEL_BUFFER_SIZE : BUFFER_SIZE;
+    basex_stream_t stream;
+    basex_stream_init(&stream, BASEX_CODEC_BASE91, decode);
+    if (decode) {
+        basex_stream_set_skip(&stream, ignore_garbage ? BASEX_SKIP_GARBAGE : BASEX_SKIP_WHITESPACE);
+    } else {
+        // Line breaks are written by the encoder, including the last one
+        basex_stream_set_wrap(&stream, wrap_cols > 0 ? (unsigned)wrap_cols : 0, false);
+    }
     
-    if (!in_buffer || !out_buffer) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return 1;
+    // With -U, io_uring keeps reads in flight ahead of the coder and the
+    // writes behind it; where it is unavailable nothing has been read yet,
+    // so the mapped/read path below takes over
+    uring_stats_t stats;
+    uring_stats_start(&stats);
+    if (use_uring) {
+        int status = uring_run(fileno(input), STDOUT_FILENO, &stream,
+                               threads != 1 ? PARALLEL_BUFFER_SIZE : URING_BUFFER_SIZE, threads, &stats);
+        if (status != URING_UNAVAILABLE) {
+            if (status == URING_CODE_ERROR) {
+                fprintf(stderr, decode ? "Decoding error\n" : "Encoding error\n");
+            } else if (status == URING_IO_ERROR) {
+                perror("io_uring");
+            } else {
+                uring_stats_report(&stats);
+            }
+            if (input != stdin) fclose(input);
+            return status == URING_OK ? 0 : 1;
+        }
     }
     
-    int line_pos = 0;
+    // Regular files are coded straight from a mapping
+    size_t mapped_len = 0;
+    size_t mapped_pos = 0;
+    uint8_t* mapped = map_input(input, &mapped_len);
     
-    // Buffer for decoded input (filter whitespace)
-    uint8_t* filtered_buffer = malloc(BUFFER_SIZE * 2);
-    if (!filtered_buffer) {
+    uint8_t* in_buffer = mapped ? NULL : malloc(buffer_size);
+    output_t out;
+    if ((!mapped && !in_buffer) ||
+        output_init(&out, STDOUT_FILENO, basex_stream_output_len(&stream, buffer_size)) < 0) {
         fprintf(stderr, "Memory allocation failed\n");
         return 1;
     }
     
-    while (1) {
-        size_t bytes_read = fread(in_buffer, 1, BUFFER_SIZE, input);
+    bool failed = false;
+    while (!failed) {
+        const uint8_t* chunk = in_buffer;
+        size_t bytes_read;
+        if (mapped) {
+            chunk = mapped + mapped_pos;
+            bytes_read = mapped_len - mapped_pos < buffer_size ? mapped_len - mapped_pos : buffer_size;
+            mapped_pos += bytes_read;
+        } else {
+            bytes_read = fread(in_buffer, 1, buffer_size, input);
+        }
         if (bytes_read == 0) break;
+        stats.in_bytes += bytes_read;
         
-        ssize_t result;
-        if (decode) {
-            // Filter out whitespace when decoding
-            size_t filtered_len = 0;
-            for (size_t i = 0; i < bytes_read; i++) {
-                if (!isspace(in_buffer[i])) {
-                    filtered_buffer[filtered_len++] = in_buffer[i];
-                }
-            }
-            
-            result = basex_base91_decode((char*)filtered_buffer, filtered_len, (uint8_t*)out_buffer);
-            if (result < 0) {
-                fprintf(stderr, "Decoding error\n");
-                free(in_buffer);
-                free(out_buffer);
-                if (input != stdin) fclose(input);
-                return 1;
-            }
-            fwrite(out_buffer, 1, result, stdout);
+        // Whitespace (and garbage with -i) is skipped by the decoder
+        ssize_t result = basex_stream_update_parallel(&stream, chunk, bytes_read,
+                                                      output_buffer(&out), threads);
+        if (result < 0) {
+            fprintf(stderr, decode ? "Decoding error\n" : "Encoding error\n");
+            failed = true;
+        } else if (output_commit(&out, (size_t)result) < 0) {
+            perror("write");
+            failed = true;
         } else {
-            result = basex_base91_encode(in_buffer, bytes_read, out_buffer);
-            if (result < 0) {
-                fprintf(stderr, "Encoding error\n");
-                free(in_buffer);
-                free(out_buffer);
-                if (input != stdin) fclose(input);
-                return 1;
-            }
-            
-            if (wrap_cols > 0) {
-                for (ssize_t i = 0; i < result; i++) {
-                    putchar(out_buffer[i]);
-                    line_pos++;
-                    if (line_pos >= wrap_cols) {
-                        putchar('\n');
-                        line_pos = 0;
-                    }
-                }
-            } else {
-                fwrite(out_buffer, 1, result, stdout);
-            }
+            stats.out_bytes += (size_t)result;
         }
     }
     
-    if (!decode && wrap_cols > 0 && line_pos > 0) {
-        putchar('\n');
+    if (!failed) {
+        ssize_t result = basex_stream_final(&stream, output_buffer(&out));
+        if (result < 0) {
+            fprintf(stderr, decode ? "Decoding error\n" : "Encoding error\n");
+            failed = true;
+        } else if (output_commit(&out, (size_t)result) < 0) {
+            perror("write");
+            failed = true;
+        } else {
+            stats.out_bytes += (size_t)result;
+        }
     }
     
+    if (mapped) munmap(mapped, mapped_len);
     free(in_buffer);
-    free(out_buffer);
-    free(filtered_buffer);
+    output_free(&out);
     if (input != stdin) fclose(input);
+    if (use_uring && !failed) uring_stats_report(&stats);
     
-    return 0;
+    return failed ? 1 : 0;
 }
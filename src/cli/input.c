@@ -0,0 +1,50 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // madvise
+#include "input.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+uint8_t* map_input(FILE* input, size_t* len) {
+    struct stat st;
+    if (fstat(fileno(input), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (unsigned long long)st.st_size > SIZE_MAX || ftello(input) != 0) {
+        return NULL;
+    }
+    
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(input), 0);
+    if (map == MAP_FAILED) return NULL;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(map, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+    *len = (size_t)st.st_size;
+    return map;
+}
+
+void release_behind(uint8_t* base, size_t pos, size_t window, size_t* released) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (pos <= window) return;
+    size_t end = (pos - window) & ~(page - 1);
+    if (end > *released) {
+        madvise(base + *released, end - *released, MADV_DONTNEED);
+        *released = end;
+    }
+}
+
+int parse_size(const char* arg, size_t* size) {
+    char* end;
+    unsigned long long value = strtoull(arg, &end, 10);
+    if (end == arg) return -1;
+    if (*end == 'K' || *end == 'k') {
+        value <<= 10;
+        end++;
+    } else if (*end == 'M' || *end == 'm') {
+        value <<= 20;
+        end++;
+    }
+    if (*end != '\0' || value > SIZE_MAX) return -1;
+    *size = (size_t)value;
+    return 0;
+}
@@ -0,0 +1,23 @@
+// Input helpers for the command-line tools
+// Regular files are mapped for one sequential pass instead of being read
+// through stdio; zbase compression drops mapped pages it has moved past.
+
+#ifndef BASEX_CLI_INPUT_H
+#define BASEX_CLI_INPUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Map a regular input file for one sequential pass. Returns NULL for
+// pipes, terminals and empty files, which are read in chunks instead.
+uint8_t* map_input(FILE* input, size_t* len);
+
+// Drop mapped input pages that have fallen out of the compression window;
+// they are re-read from the file should zstd ever look at them again
+void release_behind(uint8_t* base, size_t pos, size_t window, size_t* released);
+
+// Parse a byte count with an optional K or M suffix; -1 if malformed
+int parse_size(const char* arg, size_t* size);
+
+#endif /* BASEX_CLI_INPUT_H */
@@ -0,0 +1,128 @@
+#define _GNU_SOURCE // vmsplice, F_SETPIPE_SZ
+#include "output.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+// vmsplice() passes references to our pages, so a buffer may only be
+// refilled once the pipe no longer holds any of it. Pages are reused
+// rather than gifted: gifting needs fresh pages for every buffer, which
+// costs more than the copy it saves. A reader that moves the pages on
+// with splice() (instead of reading them) would see them change, which
+// is why this path is opt-in.
+#define NEVER ((size_t)-1)
+
+static int write_all(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static bool want_splice(int fd) {
+    const char* env = getenv("BASEX_VMSPLICE");
+    struct stat st;
+    return env && strcmp(env, "1") == 0 && fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+int output_init(output_t* out, int fd, size_t size) {
+    memset(out, 0, sizeof(*out));
+    out->fd = fd;
+    out->size = size;
+    out->splice = want_splice(fd);
+    
+    if (!out->splice) {
+        out->ring[0] = malloc(size);
+        return out->ring[0] ? 0 : -1;
+    }
+    
+    // A pipe as large as one buffer lets a whole buffer go in one call
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t aligned = (size + page - 1) & ~(page - 1);
+    fcntl(fd, F_SETPIPE_SZ, (int)(aligned < (1 << 20) ? aligned : (1 << 20)));
+    int capacity = fcntl(fd, F_GETPIPE_SZ);
+    out->capacity = capacity > 0 ? (size_t)capacity : 65536;
+    
+    for (int i = 0; i < 2; i++) {
+        out->ring[i] = aligned_alloc(page, aligned);
+        out->mark[i] = NEVER;
+        if (!out->ring[i]) return -1;
+    }
+    return 0;
+}
+
+// Whether the pipe has been read past everything spliced from buffer i
+static bool drained(const output_t* out, int i) {
+    if (out->mark[i] == NEVER) return true;
+    
+    // Pages spliced since fill the whole pipe
+    size_t after = out->total - out->mark[i];
+    if (after >= out->capacity + (size_t)sysconf(_SC_PAGESIZE)) return true;
+    
+    int unread;
+    return ioctl(out->fd, FIONREAD, &unread) == 0 && (size_t)unread <= after;
+}
+
+void* output_buffer(output_t* out) {
+    if (!out->splice) {
+        out->current = out->ring[0];
+    } else if (drained(out, out->next)) {
+        out->current = out->ring[out->next];
+    } else {
+        if (!out->bounce) out->bounce = malloc(out->size);
+        out->current = out->bounce;
+    }
+    return out->current;
+}
+
+int output_commit(output_t* out, size_t len) {
+    const uint8_t* data = out->current;
+    out->total += len;
+    
+    if (!out->splice || !data || data == out->bounce) {
+        return data ? write_all(out->fd, data, len) : -1;
+    }
+    
+    struct iovec iov = { (void*)data, len };
+    while (iov.iov_len > 0) {
+        ssize_t n = vmsplice(out->fd, &iov, 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EINVAL && errno != ENOSYS) return -1;
+            
+            // Not supported for this pipe, which shows on the first call:
+            // copy from here on
+            out->splice = false;
+            break;
+        }
+        iov.iov_base = (uint8_t*)iov.iov_base + n;
+        iov.iov_len -= (size_t)n;
+    }
+    
+    out->mark[out->next] = out->total;
+    out->next ^= 1;
+    return iov.iov_len > 0 ? write_all(out->fd, iov.iov_base, iov.iov_len) : 0;
+}
+
+int output_write(output_t* out, const void* data, size_t len) {
+    out->total += len;
+    return write_all(out->fd, data, len);
+}
+
+void output_free(output_t* out) {
+    free(out->ring[0]);
+    free(out->ring[1]);
+    free(out->bounce);
+    memset(out, 0, sizeof(*out));
+}
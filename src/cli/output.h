@@ -0,0 +1,41 @@
+// Output backend for the command-line tools
+// Encoded or decoded data is written one whole buffer at a time, straight
+// to the file descriptor. With BASEX_VMSPLICE=1 and a pipe on the other
+// end, page-aligned buffers are handed to the pipe with vmsplice() instead
+// of being copied into it.
+
+#ifndef BASEX_CLI_OUTPUT_H
+#define BASEX_CLI_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    int fd;
+    bool splice;        // vmsplice() into a pipe
+    size_t size;        // Bytes per buffer
+    size_t capacity;    // Pipe capacity
+    uint8_t* ring[2];   // Buffers filled in turn
+    size_t mark[2];     // Bytes written once a buffer was last spliced
+    int next;
+    uint8_t* bounce;    // Used while the pipe still holds the next buffer
+    uint8_t* current;
+    size_t total;       // Bytes written so far
+} output_t;
+
+// Set up buffers of size bytes for fd; -1 if they cannot be allocated
+int output_init(output_t* out, int fd, size_t size);
+
+// Buffer to fill before the next output_commit
+void* output_buffer(output_t* out);
+
+// Write the first len bytes of the buffer; -1 with errno on failure
+int output_commit(output_t* out, size_t len);
+
+// Write a small piece of data that is not in an output buffer
+int output_write(output_t* out, const void* data, size_t len);
+
+void output_free(output_t* out);
+
+#endif /* BASEX_CLI_OUTPUT_H */
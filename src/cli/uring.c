@@ -0,0 +1,402 @@
+#define _GNU_SOURCE // O_DIRECT
+#include "uring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+void uring_stats_start(uring_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    clock_gettime(CLOCK_MONOTONIC, &stats->start);
+}
+
+void uring_stats_report(const uring_stats_t* stats) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double seconds = (double)(now.tv_sec - stats->start.tv_sec) +
+                     (double)(now.tv_nsec - stats->start.tv_nsec) / 1e9;
+    double in_mb = (double)stats->in_bytes / 1e6;
+    
+    fprintf(stderr, "%s: %.1f MB in, %.1f MB out, %.3f s (%.1f MB/s)\n",
+            stats->uring ? "io_uring" : "read/write", in_mb, (double)stats->out_bytes / 1e6,
+            seconds, seconds > 0 ? in_mb / seconds : 0.0);
+}
+
+#ifndef HAVE_IO_URING
+
+int uring_run(int in_fd, int out_fd, basex_stream_t* stream, size_t chunk_size, int threads,
+              uring_stats_t* stats) {
+    (void)in_fd; (void)out_fd; (void)stream; (void)chunk_size; (void)threads; (void)stats;
+    return URING_UNAVAILABLE;
+}
+
+#else
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+// The ring is driven with the raw system calls, so no liburing is needed.
+// Regular files keep DEPTH reads in flight at increasing offsets; pipes
+// and terminals have one read in flight, which still overlaps with coding.
+// Writes go out one at a time, in order, while the next chunk is coded.
+#define DEPTH 4
+#define OUTPUTS 2
+#define ALIGN 4096
+#define DIRECT_MIN ((off_t)256 << 20) // Files this large bypass the page cache
+#define CANCEL_ID (DEPTH + OUTPUTS)    // User data of cancel requests
+
+typedef struct {
+    int fd;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_map;
+    void* cq_map;
+    size_t sq_map_size;
+    size_t cq_map_size;
+    size_t sqes_size;
+    unsigned queued;    // Prepared SQEs not passed to the kernel yet
+    unsigned in_flight;
+} ring_t;
+
+typedef struct {
+    uint8_t* buf;
+    size_t len;         // Bytes to read or write
+    size_t done;
+    off_t offset;       // Regular files: where the read starts
+    bool busy;          // Submitted and not completed
+    bool started;       // Read requested and not coded yet
+    bool eof;
+} slot_t;
+
+typedef struct {
+    ring_t ring;
+    int in_fd;
+    int out_fd;
+    bool seekable;
+    bool fixed;         // Buffers are registered with the ring
+    off_t end;          // Regular files: offset of the end
+    slot_t in[DEPTH];
+    slot_t out[OUTPUTS];
+} pipeline_t;
+
+static void ring_free(ring_t* ring) {
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map && ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map) munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->fd >= 0) close(ring->fd);
+}
+
+static void* map_ring(int fd, size_t size, off_t offset) {
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return map == MAP_FAILED ? NULL : map;
+}
+
+static int ring_init(ring_t* ring, unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(ring, 0, sizeof(*ring));
+    
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (ring->fd < 0) return -1;
+    
+    // Offset -1 (current position) for stdout needs IORING_FEAT_RW_CUR_POS,
+    // which came with IORING_OP_READ/WRITE
+    if (!(p.features & IORING_FEAT_RW_CUR_POS)) {
+        ring_free(ring);
+        return -1;
+    }
+    
+    ring->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) && ring->cq_map_size > ring->sq_map_size) {
+        ring->sq_map_size = ring->cq_map_size;
+    }
+    ring->sq_map = map_ring(ring->fd, ring->sq_map_size, IORING_OFF_SQ_RING);
+    ring->cq_map = (p.features & IORING_FEAT_SINGLE_MMAP)
+        ? ring->sq_map
+        : map_ring(ring->fd, ring->cq_map_size, IORING_OFF_CQ_RING);
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = map_ring(ring->fd, ring->sqes_size, IORING_OFF_SQES);
+    if (!ring->sq_map || !ring->cq_map || !ring->sqes) {
+        ring_free(ring);
+        return -1;
+    }
+    
+    uint8_t* sq = ring->sq_map;
+    uint8_t* cq = ring->cq_map;
+    ring->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + p.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + p.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    return 0;
+}
+
+// Pass prepared SQEs to the kernel, optionally waiting for a completion
+static int ring_enter(ring_t* ring, unsigned wait) {
+    for (;;) {
+        int ret = (int)syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait,
+                               wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (ret >= 0) {
+            ring->queued -= (unsigned)ret;
+            return 0;
+        }
+        if (errno != EINTR) return -1;
+    }
+}
+
+// The ring has room for everything in flight, so an SQE is always free
+static void ring_prepare(ring_t* ring, int op, int fd, void* buf, size_t len, off_t offset,
+                         int buf_index, uint64_t user_data) {
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t)op;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)offset;
+    sqe->buf_index = (uint16_t)buf_index;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    ring->in_flight++;
+}
+
+static int ring_wait(ring_t* ring, struct io_uring_cqe* cqe) {
+    for (;;) {
+        unsigned head = *ring->cq_head;
+        if (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            *cqe = ring->cqes[head & *ring->cq_mask];
+            __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+            ring->in_flight--;
+            return 0;
+        }
+        if (ring_enter(ring, 1) < 0) return -1;
+    }
+}
+
+// Ask the kernel to drop a request; its user data goes in addr
+static void ring_cancel(ring_t* ring, uint64_t user_data) {
+    ring_prepare(ring, IORING_OP_ASYNC_CANCEL, -1, (void*)(uintptr_t)user_data, 0, 0, 0, CANCEL_ID);
+}
+
+// Submit the rest of a read or write; user data 0..DEPTH-1 are reads
+static void submit(pipeline_t* p, unsigned id) {
+    bool read = id < DEPTH;
+    slot_t* s = read ? &p->in[id] : &p->out[id - DEPTH];
+    int op = read ? (p->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ)
+                  : (p->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE);
+    off_t offset = read && p->seekable ? s->offset + (off_t)s->done : (off_t)-1;
+    
+    ring_prepare(&p->ring, op, read ? p->in_fd : p->out_fd, s->buf + s->done, s->len - s->done,
+                 offset, (int)id, id);
+    s->busy = true;
+}
+
+static void start_read(pipeline_t* p, unsigned id, off_t offset, size_t len) {
+    slot_t* s = &p->in[id];
+    s->offset = offset;
+    s->len = len;
+    s->done = 0;
+    s->eof = false;
+    s->started = true;
+    submit(p, id);
+}
+
+// Handle one completion; -1 with errno set on an I/O error
+static int complete(pipeline_t* p) {
+    struct io_uring_cqe cqe;
+    if (ring_wait(&p->ring, &cqe) < 0) return -1;
+    
+    unsigned id = (unsigned)cqe.user_data;
+    bool read = id < DEPTH;
+    slot_t* s = read ? &p->in[id] : &p->out[id - DEPTH];
+    s->busy = false;
+    
+    if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+        submit(p, id);
+        return 0;
+    }
+    if (cqe.res < 0) {
+        errno = -cqe.res;
+        return -1;
+    }
+    
+    s->done += (size_t)cqe.res;
+    if (read) {
+        // Pipes return whatever is there; files are read to the end of the
+        // slot, or of the file (where O_DIRECT reads come back short)
+        s->eof = cqe.res == 0;
+        bool full = !p->seekable || s->eof || s->done == s->len ||
+                    s->offset + (off_t)s->done >= p->end;
+        if (!full) submit(p, id);
+    } else if (s->done < s->len) {
+        submit(p, id);
+    }
+    return 0;
+}
+
+// Write len bytes of an output slot after the other one has gone out
+static int write_slot(pipeline_t* p, unsigned k, size_t len) {
+    while (p->out[k ^ 1].busy) {
+        if (complete(p) < 0) return -1;
+    }
+    if (len > 0) {
+        p->out[k].len = len;
+        p->out[k].done = 0;
+        submit(p, DEPTH + k);
+    }
+    return ring_enter(&p->ring, 0);
+}
+
+static void free_buffers(pipeline_t* p) {
+    for (int i = 0; i < DEPTH; i++) free(p->in[i].buf);
+    for (int i = 0; i < OUTPUTS; i++) free(p->out[i].buf);
+}
+
+int uring_run(int in_fd, int out_fd, basex_stream_t* stream, size_t chunk_size, int threads,
+              uring_stats_t* stats) {
+    pipeline_t p;
+    memset(&p, 0, sizeof(p));
+    p.in_fd = in_fd;
+    p.out_fd = out_fd;
+    
+    size_t out_size = (basex_stream_output_len(stream, chunk_size) + ALIGN - 1) & ~(size_t)(ALIGN - 1);
+    struct iovec iov[DEPTH + OUTPUTS];
+    for (int i = 0; i < DEPTH + OUTPUTS; i++) {
+        size_t size = i < DEPTH ? chunk_size : out_size;
+        uint8_t* buf = aligned_alloc(ALIGN, size);
+        if (i < DEPTH) p.in[i].buf = buf; else p.out[i - DEPTH].buf = buf;
+        iov[i].iov_base = buf;
+        iov[i].iov_len = size;
+        if (!buf) {
+            free_buffers(&p);
+            return URING_UNAVAILABLE;
+        }
+    }
+    
+    if (ring_init(&p.ring, 8) < 0) {
+        free_buffers(&p);
+        return URING_UNAVAILABLE;
+    }
+    stats->uring = true;
+    
+    // Registering pins the buffers; over RLIMIT_MEMLOCK plain reads are used
+    p.fixed = syscall(__NR_io_uring_register, p.ring.fd, IORING_REGISTER_BUFFERS, iov,
+                      DEPTH + OUTPUTS) == 0;
+    
+    struct stat st;
+    off_t start = lseek(in_fd, 0, SEEK_CUR);
+    int flags = fcntl(in_fd, F_GETFL);
+    p.seekable = fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode) && start >= 0;
+    if (p.seekable) {
+        p.end = st.st_size;
+        if (st.st_size - start >= DIRECT_MIN && start % ALIGN == 0 && flags >= 0) {
+            fcntl(in_fd, F_SETFL, flags | O_DIRECT); // Stays buffered where unsupported
+        }
+    }
+    
+    int status = URING_OK;
+    off_t next_offset = start;
+    unsigned next = 0;      // Input slot coded next
+    unsigned k = 0;         // Output slot coded into next
+    
+    if (p.seekable) {
+        for (unsigned i = 0; i < DEPTH && next_offset < p.end; i++) {
+            start_read(&p, i, next_offset, chunk_size);
+            next_offset += (off_t)chunk_size;
+        }
+    } else {
+        start_read(&p, 0, 0, chunk_size);
+    }
+    if (ring_enter(&p.ring, 0) < 0) status = URING_IO_ERROR;
+    
+    while (status == URING_OK && p.in[next].started) {
+        slot_t* in = &p.in[next];
+        while (in->busy && status == URING_OK) {
+            if (complete(&p) < 0) status = URING_IO_ERROR;
+        }
+        if (status != URING_OK) break;
+        in->started = false;
+        if (in->eof && in->done == 0) break;
+    
+        // A pipe gets its next read in flight while this chunk is coded
+        if (!p.seekable && !in->eof) {
+            start_read(&p, (next + 1) % DEPTH, 0, chunk_size);
+            if (ring_enter(&p.ring, 0) < 0) {
+                status = URING_IO_ERROR;
+                break;
+            }
+        }
+    
+        ssize_t coded = basex_stream_update_parallel(stream, in->buf, in->done, p.out[k].buf, threads);
+        stats->in_bytes += in->done;
+        if (coded < 0) {
+            status = URING_CODE_ERROR;
+            break;
+        }
+    
+        // The slot is free again for the read after the ones in flight;
+        // write_slot passes it to the kernel with the write
+        if (p.seekable && next_offset < p.end) {
+            start_read(&p, next, next_offset, chunk_size);
+            next_offset += (off_t)chunk_size;
+        }
+        stats->out_bytes += (size_t)coded;
+        if (write_slot(&p, k, (size_t)coded) < 0) {
+            status = URING_IO_ERROR;
+            break;
+        }
+        k ^= 1;
+        next = (next + 1) % DEPTH;
+    }
+    
+    if (status == URING_OK) {
+        ssize_t coded = basex_stream_final(stream, p.out[k].buf);
+        if (coded < 0) {
+            status = URING_CODE_ERROR;
+        } else {
+            stats->out_bytes += (size_t)coded;
+            if (write_slot(&p, k, (size_t)coded) < 0) status = URING_IO_ERROR;
+        }
+    }
+    while (status == URING_OK && (p.out[0].busy || p.out[1].busy)) {
+        if (complete(&p) < 0) status = URING_IO_ERROR;
+    }
+    
+    // Nothing may still be reading into or writing from the buffers. After
+    // an error, a read queued ahead on a pipe or terminal may never
+    // complete (nor a write to a stalled reader), so those are cancelled
+    // first; on success everything has completed already.
+    int saved = errno;
+    if (status != URING_OK) {
+        for (unsigned id = 0; id < DEPTH + OUTPUTS; id++) {
+            if (id < DEPTH ? p.in[id].busy : p.out[id - DEPTH].busy) ring_cancel(&p.ring, id);
+        }
+    }
+    struct io_uring_cqe cqe;
+    while (p.ring.in_flight > 0 && ring_wait(&p.ring, &cqe) == 0) {}
+    errno = saved;
+    
+    if (flags >= 0 && (fcntl(in_fd, F_GETFL) & O_DIRECT) && !(flags & O_DIRECT)) {
+        fcntl(in_fd, F_SETFL, flags);
+    }
+    ring_free(&p.ring);
+    free_buffers(&p);
+    return status;
+}
+
+#endif /* HAVE_IO_URING */
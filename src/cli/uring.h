@@ -0,0 +1,34 @@
+// io_uring input/output for the command-line tools
+// Keeps several large reads in flight ahead of the coder and writes each
+// coded chunk while the next one is being coded. Buffers are registered
+// with the ring, and huge regular files are read with O_DIRECT.
+
+#ifndef BASEX_CLI_URING_H
+#define BASEX_CLI_URING_H
+
+#include "../../include/basex.h"
+#include <time.h>
+
+#define URING_OK           0
+#define URING_UNAVAILABLE -1 // No io_uring here; nothing was read
+#define URING_CODE_ERROR  -2 // The stream rejected the input
+#define URING_IO_ERROR    -3 // Read or write failed, errno is set
+
+typedef struct {
+    struct timespec start;
+    size_t in_bytes;
+    size_t out_bytes;
+    bool uring;         // Ran through io_uring rather than read/write
+} uring_stats_t;
+
+// Code everything from in_fd to out_fd in chunks of chunk_size bytes
+// (a multiple of 4096), including the final call on the stream
+int uring_run(int in_fd, int out_fd, basex_stream_t* stream, size_t chunk_size, int threads,
+              uring_stats_t* stats);
+
+void uring_stats_start(uring_stats_t* stats);
+
+// Print bytes, time and MB/s to stderr
+void uring_stats_report(const uring_stats_t* stats);
+
+#endif /* BASEX_CLI_URING_H */
@@ -1,13 +1,19 @@
 #define _POSIX_C_SOURCE 200809L
 #include "../../include/basex.h"
+#include "input.h"
+#include "output.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <getopt.h>
 #include <unistd.h>
 #include <sys/types.h>
-#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define ZSTD_STATIC_LINKING_ONLY // ZSTD_c_stableInBuffer
 #include <zstd.h>
+#include <zstd_errors.h>
 #include <stdbool.h>
 
 #define CHUNK_SIZE (128 * 1024)
@@ -20,7 +26,10 @@ static void print_usage(const char* prog) {
     printf("  -w, --wrap=COLS    Wrap encoded lines after COLS characters (default 76, 0 for no wrap)\n");
     printf("  -i, --ignore-garbage   Ignore non-alphabet characters when decoding\n");
     printf("  -l, --level=NUM    Compression level (1-19, default 9)\n");
-    printf("  -T, --threads=NUM  Number of compression threads (default 0 = auto)\n");
+    printf("  -T, --threads=NUM  Number of compression threads (default 0 = all cores,\n");
+    printf("                     1 = single-threaded)\n");
+    printf("      --job-size=SIZE    Bytes per compression job with threads (K/M suffix, 0 = auto)\n");
+    printf("      --overlap=NUM      Job overlap, 1-9 (0 = auto)\n");
     printf("  -v, --verbose      Show compression statistics\n");
     printf("  --version          Output version information\n");
     printf("  --help             Display this help and exit\n\n");
@@ -39,6 +48,8 @@ int main(int argc, char* argv[]) {
     bool ignore_garbage = false;
     int compression_level = 9;
     int threads = 0;
+    size_t job_size = 0;
+    int overlap = 0;
     bool verbose = false;
     const char* input_file = NULL;
     
@@ -48,6 +59,8 @@ int main(int argc, char* argv[]) {
         {"ignore-garbage", no_argument, 0, 'i'},
         {"level", required_argument, 0, 'l'},
         {"threads", required_argument, 0, 'T'},
+        {"job-size", required_argument, 0, 'J'},
+        {"overlap", required_argument, 0, 'O'},
         {"verbose", no_argument, 0, 'v'},
         {"version", no_argument, 0, 'V'},
         {"help", no_argument, 0, 'h'},
@@ -68,6 +81,19 @@ int main(int argc, char* argv[]) {
                 }
                 break;
             case 'T': threads = atoi(optarg); break;
+            case 'J':
+                if (parse_size(optarg, &job_size) < 0) {
+                    fprintf(stderr, "Invalid job size: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'O':
+                overlap = atoi(optarg);
+                if (overlap < 0 || overlap > 9) {
+                    fprintf(stderr, "Invalid overlap: %s (must be 0-9)\n", optarg);
+                    return 1;
+                }
+                break;
             case 'v': verbose = true; break;
             case 'V': print_version(); return 0;
             case 'h': print_usage(argv[0]); return 0;
@@ -89,209 +115,294 @@ int main(int argc, char* argv[]) {
     }
     
     if (!decode_mode) {
-        // ENCODE MODE: Read all input, compress once, then encode
+        // ENCODE MODE: compress and encode in one pass. Memory stays at
+        // the zstd window plus a few fixed buffers, whatever the input size.
+        ZSTD_CCtx* cctx = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compression_level);
+        
+        // -T 0 uses every online core; -T 1 stays on this thread, which
+        // gives the same output as a one-shot compression
+        if (threads <= 0) {
+            long cores = sysconf(_SC_NPROCESSORS_ONLN);
+            threads = cores > 0 ? (int)cores : 1;
+        }
+        int workers = 0;
+        if (threads > 1) {
+            // Fails (leaving 0 workers) if libzstd was built without threads
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, threads);
+            ZSTD_CCtx_getParameter(cctx, ZSTD_c_nbWorkers, &workers);
+        }
+        if (workers > 0) {
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_jobSize, (int)(job_size > INT_MAX ? INT_MAX : job_size));
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_overlapLog, overlap);
+        }
+        
+        basex_stream_t stream;
+        basex_stream_init(&stream, BASEX_CODEC_BASE32, false);
+        basex_stream_set_wrap(&stream, wrap > 0 ? (unsigned)wrap : 0, false);
         
-        // Read all input data into memory
-        size_t buffer_capacity = CHUNK_SIZE;
-        size_t buffer_size = 0;
-        uint8_t* buffer = malloc(buffer_capacity);
-        if (!buffer) {
+        size_t in_size = ZSTD_CStreamInSize();
+        size_t zout_size = ZSTD_CStreamOutSize();
+        uint8_t* in_buffer = malloc(in_size);
+        uint8_t* compressed = malloc(zout_size);
+        output_t out;
+        int out_status = output_init(&out, STDOUT_FILENO, basex_stream_output_len(&stream, zout_size));
+        if (!cctx || !in_buffer || !compressed || out_status < 0) {
             perror("malloc");
+            ZSTD_freeCCtx(cctx);
+            free(in_buffer);
+            free(compressed);
+            output_free(&out);
             if (input != stdin) fclose(input);
             return 1;
         }
         
-        while (1) {
-            if (buffer_size >= buffer_capacity) {
-                buffer_capacity *= 2;
-                uint8_t* new_buffer = realloc(buffer, buffer_capacity);
-                if (!new_buffer) {
-                    perror("realloc");
-                    free(buffer);
-                    if (input != stdin) fclose(input);
-                    return 1;
-                }
-                buffer = new_buffer;
-            }
-            
-            size_t bytes_read = fread(buffer + buffer_size, 1, buffer_capacity - buffer_size, input);
-            if (bytes_read == 0) break;
-            buffer_size += bytes_read;
+        // zstd picks its parameters and frame header from the input size,
+        // so pass it on whenever it is known up front
+        unsigned long long pledged_size = ZSTD_CONTENTSIZE_UNKNOWN;
+        struct stat st;
+        off_t start = ftello(input);
+        if (fstat(fileno(input), &st) == 0 && S_ISREG(st.st_mode) && start >= 0 &&
+            st.st_size >= start) {
+            pledged_size = (unsigned long long)(st.st_size - start);
         }
         
-        // Compress the entire input
-        size_t compressed_bound = ZSTD_compressBound(buffer_size);
-        uint8_t* compressed = malloc(compressed_bound);
-        if (!compressed) {
-            perror("malloc compressed");
-            free(buffer);
-            if (input != stdin) fclose(input);
-            return 1;
+        // Regular files are mapped and compressed in place. With a stable
+        // input buffer zstd keeps the whole file as history, exactly like a
+        // one-shot compression; copying through its own window buffer
+        // would give different (equally valid) output past the window size.
+        // Worker threads copy their jobs anyway.
+        uint8_t* mapped = NULL;
+        size_t mapped_len = 0;
+        if (workers == 0) {
+            mapped = map_input(input, &mapped_len);
+            if (mapped && ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_stableInBuffer, 1))) {
+                munmap(mapped, mapped_len);
+                mapped = NULL;
+            }
         }
+        size_t window = (size_t)1 << ZSTD_getCParams(compression_level, pledged_size, 0).windowLog;
+        size_t released = 0;
         
-        ZSTD_CCtx* cctx = ZSTD_createCCtx();
-        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compression_level);
-        if (threads > 0 || threads == 0) {
-            ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, threads);
+        size_t input_size = 0;
+        size_t compressed_size = 0;
+        size_t encoded_size = 0;
+        bool first = true;
+        bool last = false;
+        bool failed = false;
+        
+        while (!last && !failed) {
+            ZSTD_inBuffer zin = { mapped, mapped_len, 0 };
+            if (mapped) {
+                last = true;
+            } else {
+                zin.src = in_buffer;
+                zin.size = fread(in_buffer, 1, in_size, input);
+                if (ferror(input)) {
+                    perror("fread");
+                    failed = true;
+                    break;
+                }
+                last = zin.size < in_size;
+            }
+            input_size += zin.size;
+            
+            if (first) {
+                if (!mapped && last) pledged_size = zin.size; // Whole input in one read
+                ZSTD_CCtx_setPledgedSrcSize(cctx, pledged_size);
+                first = false;
+            }
+            
+            ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+            bool flushed = false;
+            do {
+                ZSTD_outBuffer zout = { compressed, zout_size, 0 };
+                size_t remaining = ZSTD_compressStream2(cctx, &zout, &zin, mode);
+                if (ZSTD_isError(remaining)) {
+                    fprintf(stderr, "zstd compression error: %s\n", ZSTD_getErrorName(remaining));
+                    failed = true;
+                    break;
+                }
+                compressed_size += zout.pos;
+                
+                // Base32 encode the compressed block
+                ssize_t result = basex_stream_update(&stream, compressed, zout.pos,
+                                                     output_buffer(&out));
+                if (result < 0) {
+                    fprintf(stderr, "Base32 encoding error\n");
+                    failed = true;
+                    break;
+                }
+                if (output_commit(&out, (size_t)result) < 0) {
+                    perror("write");
+                    failed = true;
+                    break;
+                }
+                encoded_size += result;
+                
+                if (mapped) release_behind(mapped, zin.pos, window, &released);
+                flushed = last ? remaining == 0 : zin.pos == zin.size;
+            } while (!flushed);
         }
         
-        size_t compressed_size = ZSTD_compressCCtx(cctx, compressed, compressed_bound,
-                                                     buffer, buffer_size, compression_level);
         ZSTD_freeCCtx(cctx);
-        free(buffer);
+        if (mapped) munmap(mapped, mapped_len);
+        free(in_buffer);
+        free(compressed);
         
-        if (ZSTD_isError(compressed_size)) {
-            fprintf(stderr, "zstd compression error: %s\n", ZSTD_getErrorName(compressed_size));
-            free(compressed);
+        if (failed) {
+            output_free(&out);
             if (input != stdin) fclose(input);
             return 1;
         }
         
-        // Base32 encode the compressed data
-        size_t encoded_len = basex_base32_encode_len(compressed_size);
-        char* encoded = malloc(encoded_len + 1);
-        if (!encoded) {
-            perror("malloc encoded");
-            free(compressed);
-            if (input != stdin) fclose(input);
-            return 1;
-        }
-        
-        ssize_t result = basex_base32_encode(compressed, compressed_size, encoded);
-        free(compressed);
-        
+        ssize_t result = basex_stream_final(&stream, output_buffer(&out));
         if (result < 0) {
             fprintf(stderr, "Base32 encoding error\n");
-            free(encoded);
+            output_free(&out);
             if (input != stdin) fclose(input);
             return 1;
         }
+        encoded_size += result;
         
-        // Write with line wrapping
-        if (wrap > 0) {
-            for (ssize_t i = 0; i < result; i++) {
-                putchar(encoded[i]);
-                if ((i + 1) % wrap == 0) {
-                    putchar('\n');
-                }
-            }
-            if (result % wrap != 0) {
-                putchar('\n');
-            }
-        } else {
-            fwrite(encoded, 1, result, stdout);
-            putchar('\n');
+        // Wrapped output ends its last line itself
+        if (output_commit(&out, (size_t)result) < 0 ||
+            (wrap <= 0 && output_write(&out, "\n", 1) < 0)) {
+            perror("write");
+            output_free(&out);
+            if (input != stdin) fclose(input);
+            return 1;
         }
         
         if (verbose) {
-            fprintf(stderr, "Input: %zu bytes → Compressed: %zu bytes (%.1f%%) → Encoded: %zd bytes\n",
-                    buffer_size, compressed_size,
-                    (100.0 * compressed_size) / buffer_size,
-                    result);
+            fprintf(stderr, "Input: %zu bytes → Compressed: %zu bytes (%.1f%%) → Encoded: %zu bytes\n",
+                    input_size, compressed_size,
+                    (100.0 * compressed_size) / input_size,
+                    encoded_size);
+            if (workers > 0) {
+                fprintf(stderr, "Compression: level %d, %d worker threads\n", compression_level, workers);
+            } else {
+                fprintf(stderr, "Compression: level %d, single-threaded\n", compression_level);
+            }
         }
         
-        free(encoded);
+        output_free(&out);
         
     } else {
-        // DECODE MODE: Read all encoded input, decode, then decompress
+        // DECODE MODE: decode and decompress in one pass with fixed buffers.
+        // Concatenated zstd frames are decompressed one after another.
+        basex_stream_t stream;
+        basex_stream_init(&stream, BASEX_CODEC_BASE32, true);
+        basex_stream_set_skip(&stream, ignore_garbage ? BASEX_SKIP_GARBAGE : BASEX_SKIP_WHITESPACE);
         
-        // Read all encoded input
-        size_t buffer_capacity = CHUNK_SIZE;
-        size_t buffer_size = 0;
-        char* buffer = malloc(buffer_capacity);
-        if (!buffer) {
+        size_t zout_size = ZSTD_DStreamOutSize();
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        char* buffer = malloc(CHUNK_SIZE);
+        uint8_t* decoded = malloc(basex_stream_output_len(&stream, CHUNK_SIZE) +
+                                  basex_stream_output_len(&stream, 0));
+        output_t out;
+        int out_status = output_init(&out, STDOUT_FILENO, zout_size);
+        if (!dctx || !buffer || !decoded || out_status < 0) {
             perror("malloc");
+            ZSTD_freeDCtx(dctx);
+            free(buffer);
+            free(decoded);
+            output_free(&out);
             if (input != stdin) fclose(input);
             return 1;
         }
         
-        while (1) {
-            if (buffer_size >= buffer_capacity) {
-                buffer_capacity *= 2;
-                char* new_buffer = realloc(buffer, buffer_capacity);
-                if (!new_buffer) {
-                    perror("realloc");
-                    free(buffer);
-                    if (input != stdin) fclose(input);
-                    return 1;
+        size_t decoded_size = 0;
+        size_t decompressed_size = 0;
+        size_t frame_remaining = 0; // Non-zero while inside a frame
+        bool last = false;
+        bool failed = false;
+        
+        // Regular files are decoded straight from a mapping
+        size_t mapped_len = 0;
+        size_t mapped_pos = 0;
+        uint8_t* mapped = map_input(input, &mapped_len);
+        
+        while (!last && !failed) {
+            const char* chunk = buffer;
+            size_t bytes_read;
+            if (mapped) {
+                chunk = (const char*)mapped + mapped_pos;
+                bytes_read = mapped_len - mapped_pos < CHUNK_SIZE ? mapped_len - mapped_pos : CHUNK_SIZE;
+                mapped_pos += bytes_read;
+                last = mapped_pos == mapped_len;
+            } else {
+                bytes_read = fread(buffer, 1, CHUNK_SIZE, input);
+                if (ferror(input)) {
+                    perror("fread");
+                    failed = true;
+                    break;
                 }
-                buffer = new_buffer;
+                last = bytes_read < CHUNK_SIZE;
             }
             
-            size_t bytes_read = fread(buffer + buffer_size, 1, buffer_capacity - buffer_size, input);
-            if (bytes_read == 0) break;
-            buffer_size += bytes_read;
-        }
-        
-        // Filter whitespace
-        size_t filtered_len = 0;
-        for (size_t i = 0; i < buffer_size; i++) {
-            if (!isspace((unsigned char)buffer[i])) {
-                buffer[filtered_len++] = buffer[i];
+            // Base32 decode, skipping whitespace (and garbage with -i)
+            ssize_t result = basex_stream_update(&stream, chunk, bytes_read, decoded);
+            if (result >= 0 && last) {
+                ssize_t tail = basex_stream_final(&stream, decoded + result);
+                result = tail < 0 ? -1 : result + tail;
+            }
+            if (result < 0) {
+                fprintf(stderr, "Base32 decoding error\n");
+                failed = true;
+                break;
+            }
+            decoded_size += result;
+            
+            // Decompress; a full output buffer may leave more of the current
+            // frame to flush
+            ZSTD_inBuffer zin = { decoded, (size_t)result, 0 };
+            bool more = zin.size > 0;
+            while (more) {
+                ZSTD_outBuffer zout = { output_buffer(&out), zout_size, 0 };
+                size_t ret = ZSTD_decompressStream(dctx, &zout, &zin);
+                if (ZSTD_isError(ret)) {
+                    if (ZSTD_getErrorCode(ret) == ZSTD_error_prefix_unknown) {
+                        fprintf(stderr, "Not compressed by zstd\n");
+                    } else {
+                        fprintf(stderr, "zstd decompression error: %s\n", ZSTD_getErrorName(ret));
+                    }
+                    failed = true;
+                    break;
+                }
+                if (output_commit(&out, zout.pos) < 0) {
+                    perror("write");
+                    failed = true;
+                    break;
+                }
+                decompressed_size += zout.pos;
+                frame_remaining = ret;
+                more = zin.pos < zin.size || (zout.pos == zout.size && ret != 0);
             }
         }
         
-        // Base32 decode
-        size_t decoded_len = basex_base32_decode_len(filtered_len);
-        uint8_t* decoded = malloc(decoded_len);
-        if (!decoded) {
-            perror("malloc decoded");
-            free(buffer);
-            if (input != stdin) fclose(input);
-            return 1;
-        }
-        
-        ssize_t result = basex_base32_decode(buffer, filtered_len, decoded);
+        ZSTD_freeDCtx(dctx);
+        if (mapped) munmap(mapped, mapped_len);
         free(buffer);
+        free(decoded);
+        output_free(&out);
         
-        if (result < 0) {
-            fprintf(stderr, "Base32 decoding error\n");
-            free(decoded);
-            if (input != stdin) fclose(input);
-            return 1;
-        }
-        
-        // Decompress
-        unsigned long long decompressed_size = ZSTD_getFrameContentSize(decoded, result);
-        if (decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
+        if (!failed && decoded_size == 0) {
             fprintf(stderr, "Not compressed by zstd\n");
-            free(decoded);
-            if (input != stdin) fclose(input);
-            return 1;
-        }
-        if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
-            decompressed_size = result * 20;  // Estimate
+            failed = true;
+        } else if (!failed && frame_remaining != 0) {
+            fprintf(stderr, "zstd decompression error: truncated input\n");
+            failed = true;
         }
-        
-        uint8_t* decompressed = malloc(decompressed_size);
-        if (!decompressed) {
-            perror("malloc decompressed");
-            free(decoded);
+        if (failed) {
             if (input != stdin) fclose(input);
             return 1;
         }
         
-        ZSTD_DCtx* dctx = ZSTD_createDCtx();
-        size_t decomp_result = ZSTD_decompressDCtx(dctx, decompressed, decompressed_size,
-                                                     decoded, result);
-        ZSTD_freeDCtx(dctx);
-        free(decoded);
-        
-        if (ZSTD_isError(decomp_result)) {
-            fprintf(stderr, "zstd decompression error: %s\n", ZSTD_getErrorName(decomp_result));
-            free(decompressed);
-            if (input != stdin) fclose(input);
-            return 1;
-        }
-        
-        fwrite(decompressed, 1, decomp_result, stdout);
-        
         if (verbose) {
             fprintf(stderr, "Decoded: %zu bytes → Decompressed: %zu bytes\n",
-                    (size_t)result, decomp_result);
+                    decoded_size, decompressed_size);
         }
-        
-        free(decompressed);
     }
     
     if (input != stdin) fclose(input);
@@ -1,4 +1,7 @@
 #include "../../include/basex.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include "stream.h"
 #include <string.h>
 
 // Base122 encoding - Portable implementation
@@ -35,8 +38,15 @@ ssize_t basex_base122_encode(const uint8_t* input, size_t input_len, char* outpu
     size_t out_pos = 0;
     uint32_t accumulator = 0;
     int bits = 0;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
+    // Whole 7-byte blocks leave no pending bits
+    const basex_kernels_t* kernels = basex_kernels();
+    i = kernels->base122.encode(input, input_len, output);
+    i += kernels->base122.encode_tail(input + i, input_len - i, output + (i / 7) * 8);
+    out_pos = (i / 7) * 8;
+    
+    for (; i < input_len; i++) {
         accumulator = (accumulator << 8) | input[i];
         bits += 8;
         
@@ -76,12 +86,51 @@ ssize_t basex_base122_encode(const uint8_t* input, size_t input_len, char* outpu
 ssize_t basex_base122_decode(const char* input, size_t input_len, uint8_t* output) {
     if (!input || !output) return -1;
     
+    basex_stream_t stream = { .codec = BASEX_CODEC_BASE122, .decode = true };
+    return basex_base122_stream_decode(&stream, input, input_len, output);
+}
+
+ssize_t basex_base122_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                    uint8_t* output) {
     size_t out_pos = 0;
-    uint32_t accumulator = 0;
-    int bits = 0;
-    bool escaped = false;
+    uint32_t accumulator = (uint32_t)stream->accumulator;
+    int bits = (int)stream->bits;
+    bool escaped = stream->escaped;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
+    for (;;) {
+        // The block kernels start with nothing pending, which a stream
+        // reaches again within 8 values
+        if (bits == 0 && !escaped) {
+            size_t tail_len = 0;
+            
+            const basex_kernels_t* kernels = basex_kernels();
+            i += kernels->base122.decode(input + i, input_len - i, output + out_pos, &tail_len);
+            out_pos += tail_len;
+            i += kernels->base122.decode_tail(input + i, input_len - i, output + out_pos, &tail_len);
+            out_pos += tail_len;
+            break;
+        }
+        if (i >= input_len) break;
+        
+        uint8_t byte = (uint8_t)input[i++];
+        if (byte == 0xC2 && !escaped) {
+            escaped = true;
+            continue;
+        }
+        
+        accumulator = (accumulator << 7) | (byte & 0x7F);
+        bits += 7;
+        escaped = false;
+        
+        if (bits >= 8) {
+            bits -= 8;
+            output[out_pos++] = (accumulator >> bits) & 0xFF;
+            accumulator &= (1 << bits) - 1;
+        }
+    }
+    
+    for (; i < input_len; i++) {
         uint8_t byte = (uint8_t)input[i];
         
         // Handle escape sequences
@@ -104,5 +153,22 @@ ssize_t basex_base122_decode(const char* input, size_t input_len, uint8_t* outpu
         }
     }
     
+    stream->accumulator = accumulator;
+    stream->bits = (unsigned)bits;
+    stream->escaped = escaped;
     return out_pos;
 }
+
+size_t basex_base122_count_values(const char* input, size_t input_len) {
+    const char* end = input + input_len;
+    const char* p = input;
+    size_t markers = 0;
+    
+    // Each marker escapes the byte after it, whatever that byte is
+    while (p < end && (p = memchr(p, 0xC2, (size_t)(end - p))) != NULL) {
+        markers++;
+        p += 2;
+    }
+    
+    return input_len - markers;
+}
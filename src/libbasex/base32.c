@@ -1,4 +1,7 @@
 #include "../../include/basex.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include "stream.h"
 #include <string.h>
 
 // Base32 encoding (RFC 4648)
@@ -39,8 +42,15 @@ ssize_t basex_base32_encode(const uint8_t* input, size_t input_len, char* output
     size_t out_pos = 0;
     uint64_t buffer = 0;
     int bits = 0;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
+    const basex_kernels_t* kernels = basex_kernels();
+    i = kernels->base32.encode(input, input_len, output);
+    // Block kernels stop on a group boundary, so the tail picks up there
+    i += kernels->base32.encode_tail(input + i, input_len - i, output + (i / 5) * 8);
+    out_pos = (i / 5) * 8;
+    
+    for (; i < input_len; i++) {
         buffer = (buffer << 8) | input[i];
         bits += 8;
         
@@ -64,15 +74,43 @@ ssize_t basex_base32_encode(const uint8_t* input, size_t input_len, char* output
 ssize_t basex_base32_decode(const char* input, size_t input_len, uint8_t* output) {
     if (!input || !output) return -1;
     
+    basex_stream_t stream = { .codec = BASEX_CODEC_BASE32, .decode = true };
+    return basex_base32_stream_decode(&stream, input, input_len, output);
+}
+
+ssize_t basex_base32_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output) {
     size_t out_pos = 0;
-    uint64_t buffer = 0;
-    int bits = 0;
+    uint64_t buffer = stream->accumulator;
+    int bits = (int)stream->bits;
+    bool kernel_run = false;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
-        if (input[i] == '=') break;
+    if (stream->done) return 0;
+    
+    for (; i < input_len; i++) {
+        // The block kernel starts on a group boundary, which a stream
+        // reaches again within a few characters
+        if (bits == 0 && !kernel_run) {
+            size_t written = 0;
+            i += basex_kernels()->base32.decode(input + i, input_len - i, output + out_pos,
+                                                &written);
+            out_pos += written;
+            kernel_run = true;
+            if (i >= input_len) break;
+        }
+        
+        if (input[i] == '=') {
+            stream->done = true;
+            break;
+        }
         
         int8_t c = BASE32_DECODE_TABLE[(uint8_t)input[i]];
-        if (c < 0) continue;
+        if (c < 0) {
+            // Whitespace was dropped in front of the core; anything else is garbage
+            if (stream->skip == BASEX_SKIP_WHITESPACE) return -1;
+            continue;
+        }
         
         buffer = (buffer << 5) | c;
         bits += 5;
@@ -83,5 +121,21 @@ ssize_t basex_base32_decode(const char* input, size_t input_len, uint8_t* output
         }
     }
     
+    stream->accumulator = buffer & ((1u << bits) - 1);
+    stream->bits = (unsigned)bits;
     return out_pos;
 }
+
+size_t basex_base32_count_symbols(const char* input, size_t input_len, size_t limit,
+                                  size_t* consumed) {
+    size_t count = 0;
+    size_t i = 0;
+    
+    for (; i < input_len && count < limit; i++) {
+        if (input[i] == '=') break;
+        count += BASE32_DECODE_TABLE[(uint8_t)input[i]] >= 0;
+    }
+    
+    *consumed = i;
+    return count;
+}
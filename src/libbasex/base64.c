@@ -1,4 +1,7 @@
 #include "../../include/basex.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include "stream.h"
 #include <string.h>
 
 // Base64 encoding (RFC 4648)
@@ -9,25 +12,126 @@ static const char BASE64_ALPHABET[] =
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
-static const int8_t BASE64_DECODE_TABLE[256] = {
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
-    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
-    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
-    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
-    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+// Character values (-1 outside the alphabet), as an X-macro so the
+// decode tables below are all built from one list
+#define BASE64_VALUES(X) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(62) X(-1) X(-1) X(-1) X(63) \
+    X(52) X(53) X(54) X(55) X(56) X(57) X(58) X(59) X(60) X(61) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X( 0) X( 1) X( 2) X( 3) X( 4) X( 5) X( 6) X( 7) X( 8) X( 9) X(10) X(11) X(12) X(13) X(14) \
+    X(15) X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(26) X(27) X(28) X(29) X(30) X(31) X(32) X(33) X(34) X(35) X(36) X(37) X(38) X(39) X(40) \
+    X(41) X(42) X(43) X(44) X(45) X(46) X(47) X(48) X(49) X(50) X(51) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) \
+    X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1) X(-1)
+
+#define AS_INT8(v) v,
+static const int8_t BASE64_DECODE_TABLE[256] = { BASE64_VALUES(AS_INT8) };
+
+// Decode tables pre-shifted to each position of a quad, so one quad is
+// four lookups OR-ed together. Invalid characters set bit 24.
+#define BASE64_BAD 0x01000000u
+#define AS_SHIFT18(v) ((v) < 0 ? BASE64_BAD : (uint32_t)(v) << 18),
+#define AS_SHIFT12(v) ((v) < 0 ? BASE64_BAD : (uint32_t)(v) << 12),
+#define AS_SHIFT6(v) ((v) < 0 ? BASE64_BAD : (uint32_t)(v) << 6),
+#define AS_SHIFT0(v) ((v) < 0 ? BASE64_BAD : (uint32_t)(v)),
+static const uint32_t BASE64_DECODE_QUAD[4][256] = {
+    { BASE64_VALUES(AS_SHIFT18) },
+    { BASE64_VALUES(AS_SHIFT12) },
+    { BASE64_VALUES(AS_SHIFT6) },
+    { BASE64_VALUES(AS_SHIFT0) }
 };
 
+// Both characters for every 12-bit value (row = first character), so
+// 3 bytes take two lookups
+static const union {
+    char rows[64][128];
+    char flat[4096 * 2];
+} BASE64_PAIRS = { .rows = {
+    "AAABACADAEAFAGAHAIAJAKALAMANAOAPAQARASATAUAVAWAXAYAZAaAbAcAdAeAfAgAhAiAjAkAlAmAnAoApAqArAsAtAuAvAwAxAyAzA0A1A2A3A4A5A6A7A8A9A+A/",
+    "BABBBCBDBEBFBGBHBIBJBKBLBMBNBOBPBQBRBSBTBUBVBWBXBYBZBaBbBcBdBeBfBgBhBiBjBkBlBmBnBoBpBqBrBsBtBuBvBwBxByBzB0B1B2B3B4B5B6B7B8B9B+B/",
+    "CACBCCCDCECFCGCHCICJCKCLCMCNCOCPCQCRCSCTCUCVCWCXCYCZCaCbCcCdCeCfCgChCiCjCkClCmCnCoCpCqCrCsCtCuCvCwCxCyCzC0C1C2C3C4C5C6C7C8C9C+C/",
+    "DADBDCDDDEDFDGDHDIDJDKDLDMDNDODPDQDRDSDTDUDVDWDXDYDZDaDbDcDdDeDfDgDhDiDjDkDlDmDnDoDpDqDrDsDtDuDvDwDxDyDzD0D1D2D3D4D5D6D7D8D9D+D/",
+    "EAEBECEDEEEFEGEHEIEJEKELEMENEOEPEQERESETEUEVEWEXEYEZEaEbEcEdEeEfEgEhEiEjEkElEmEnEoEpEqErEsEtEuEvEwExEyEzE0E1E2E3E4E5E6E7E8E9E+E/",
+    "FAFBFCFDFEFFFGFHFIFJFKFLFMFNFOFPFQFRFSFTFUFVFWFXFYFZFaFbFcFdFeFfFgFhFiFjFkFlFmFnFoFpFqFrFsFtFuFvFwFxFyFzF0F1F2F3F4F5F6F7F8F9F+F/",
+    "GAGBGCGDGEGFGGGHGIGJGKGLGMGNGOGPGQGRGSGTGUGVGWGXGYGZGaGbGcGdGeGfGgGhGiGjGkGlGmGnGoGpGqGrGsGtGuGvGwGxGyGzG0G1G2G3G4G5G6G7G8G9G+G/",
+    "HAHBHCHDHEHFHGHHHIHJHKHLHMHNHOHPHQHRHSHTHUHVHWHXHYHZHaHbHcHdHeHfHgHhHiHjHkHlHmHnHoHpHqHrHsHtHuHvHwHxHyHzH0H1H2H3H4H5H6H7H8H9H+H/",
+    "IAIBICIDIEIFIGIHIIIJIKILIMINIOIPIQIRISITIUIVIWIXIYIZIaIbIcIdIeIfIgIhIiIjIkIlImInIoIpIqIrIsItIuIvIwIxIyIzI0I1I2I3I4I5I6I7I8I9I+I/",
+    "JAJBJCJDJEJFJGJHJIJJJKJLJMJNJOJPJQJRJSJTJUJVJWJXJYJZJaJbJcJdJeJfJgJhJiJjJkJlJmJnJoJpJqJrJsJtJuJvJwJxJyJzJ0J1J2J3J4J5J6J7J8J9J+J/",
+    "KAKBKCKDKEKFKGKHKIKJKKKLKMKNKOKPKQKRKSKTKUKVKWKXKYKZKaKbKcKdKeKfKgKhKiKjKkKlKmKnKoKpKqKrKsKtKuKvKwKxKyKzK0K1K2K3K4K5K6K7K8K9K+K/",
+    "LALBLCLDLELFLGLHLILJLKLLLMLNLOLPLQLRLSLTLULVLWLXLYLZLaLbLcLdLeLfLgLhLiLjLkLlLmLnLoLpLqLrLsLtLuLvLwLxLyLzL0L1L2L3L4L5L6L7L8L9L+L/",
+    "MAMBMCMDMEMFMGMHMIMJMKMLMMMNMOMPMQMRMSMTMUMVMWMXMYMZMaMbMcMdMeMfMgMhMiMjMkMlMmMnMoMpMqMrMsMtMuMvMwMxMyMzM0M1M2M3M4M5M6M7M8M9M+M/",
+    "NANBNCNDNENFNGNHNINJNKNLNMNNNONPNQNRNSNTNUNVNWNXNYNZNaNbNcNdNeNfNgNhNiNjNkNlNmNnNoNpNqNrNsNtNuNvNwNxNyNzN0N1N2N3N4N5N6N7N8N9N+N/",
+    "OAOBOCODOEOFOGOHOIOJOKOLOMONOOOPOQOROSOTOUOVOWOXOYOZOaObOcOdOeOfOgOhOiOjOkOlOmOnOoOpOqOrOsOtOuOvOwOxOyOzO0O1O2O3O4O5O6O7O8O9O+O/",
+    "PAPBPCPDPEPFPGPHPIPJPKPLPMPNPOPPPQPRPSPTPUPVPWPXPYPZPaPbPcPdPePfPgPhPiPjPkPlPmPnPoPpPqPrPsPtPuPvPwPxPyPzP0P1P2P3P4P5P6P7P8P9P+P/",
+    "QAQBQCQDQEQFQGQHQIQJQKQLQMQNQOQPQQQRQSQTQUQVQWQXQYQZQaQbQcQdQeQfQgQhQiQjQkQlQmQnQoQpQqQrQsQtQuQvQwQxQyQzQ0Q1Q2Q3Q4Q5Q6Q7Q8Q9Q+Q/",
+    "RARBRCRDRERFRGRHRIRJRKRLRMRNRORPRQRRRSRTRURVRWRXRYRZRaRbRcRdReRfRgRhRiRjRkRlRmRnRoRpRqRrRsRtRuRvRwRxRyRzR0R1R2R3R4R5R6R7R8R9R+R/",
+    "SASBSCSDSESFSGSHSISJSKSLSMSNSOSPSQSRSSSTSUSVSWSXSYSZSaSbScSdSeSfSgShSiSjSkSlSmSnSoSpSqSrSsStSuSvSwSxSySzS0S1S2S3S4S5S6S7S8S9S+S/",
+    "TATBTCTDTETFTGTHTITJTKTLTMTNTOTPTQTRTSTTTUTVTWTXTYTZTaTbTcTdTeTfTgThTiTjTkTlTmTnToTpTqTrTsTtTuTvTwTxTyTzT0T1T2T3T4T5T6T7T8T9T+T/",
+    "UAUBUCUDUEUFUGUHUIUJUKULUMUNUOUPUQURUSUTUUUVUWUXUYUZUaUbUcUdUeUfUgUhUiUjUkUlUmUnUoUpUqUrUsUtUuUvUwUxUyUzU0U1U2U3U4U5U6U7U8U9U+U/",
+    "VAVBVCVDVEVFVGVHVIVJVKVLVMVNVOVPVQVRVSVTVUVVVWVXVYVZVaVbVcVdVeVfVgVhViVjVkVlVmVnVoVpVqVrVsVtVuVvVwVxVyVzV0V1V2V3V4V5V6V7V8V9V+V/",
+    "WAWBWCWDWEWFWGWHWIWJWKWLWMWNWOWPWQWRWSWTWUWVWWWXWYWZWaWbWcWdWeWfWgWhWiWjWkWlWmWnWoWpWqWrWsWtWuWvWwWxWyWzW0W1W2W3W4W5W6W7W8W9W+W/",
+    "XAXBXCXDXEXFXGXHXIXJXKXLXMXNXOXPXQXRXSXTXUXVXWXXXYXZXaXbXcXdXeXfXgXhXiXjXkXlXmXnXoXpXqXrXsXtXuXvXwXxXyXzX0X1X2X3X4X5X6X7X8X9X+X/",
+    "YAYBYCYDYEYFYGYHYIYJYKYLYMYNYOYPYQYRYSYTYUYVYWYXYYYZYaYbYcYdYeYfYgYhYiYjYkYlYmYnYoYpYqYrYsYtYuYvYwYxYyYzY0Y1Y2Y3Y4Y5Y6Y7Y8Y9Y+Y/",
+    "ZAZBZCZDZEZFZGZHZIZJZKZLZMZNZOZPZQZRZSZTZUZVZWZXZYZZZaZbZcZdZeZfZgZhZiZjZkZlZmZnZoZpZqZrZsZtZuZvZwZxZyZzZ0Z1Z2Z3Z4Z5Z6Z7Z8Z9Z+Z/",
+    "aAaBaCaDaEaFaGaHaIaJaKaLaMaNaOaPaQaRaSaTaUaVaWaXaYaZaaabacadaeafagahaiajakalamanaoapaqarasatauavawaxayaza0a1a2a3a4a5a6a7a8a9a+a/",
+    "bAbBbCbDbEbFbGbHbIbJbKbLbMbNbObPbQbRbSbTbUbVbWbXbYbZbabbbcbdbebfbgbhbibjbkblbmbnbobpbqbrbsbtbubvbwbxbybzb0b1b2b3b4b5b6b7b8b9b+b/",
+    "cAcBcCcDcEcFcGcHcIcJcKcLcMcNcOcPcQcRcScTcUcVcWcXcYcZcacbcccdcecfcgchcicjckclcmcncocpcqcrcsctcucvcwcxcyczc0c1c2c3c4c5c6c7c8c9c+c/",
+    "dAdBdCdDdEdFdGdHdIdJdKdLdMdNdOdPdQdRdSdTdUdVdWdXdYdZdadbdcdddedfdgdhdidjdkdldmdndodpdqdrdsdtdudvdwdxdydzd0d1d2d3d4d5d6d7d8d9d+d/",
+    "eAeBeCeDeEeFeGeHeIeJeKeLeMeNeOePeQeReSeTeUeVeWeXeYeZeaebecedeeefegeheiejekelemeneoepeqereseteuevewexeyeze0e1e2e3e4e5e6e7e8e9e+e/",
+    "fAfBfCfDfEfFfGfHfIfJfKfLfMfNfOfPfQfRfSfTfUfVfWfXfYfZfafbfcfdfefffgfhfifjfkflfmfnfofpfqfrfsftfufvfwfxfyfzf0f1f2f3f4f5f6f7f8f9f+f/",
+    "gAgBgCgDgEgFgGgHgIgJgKgLgMgNgOgPgQgRgSgTgUgVgWgXgYgZgagbgcgdgegfggghgigjgkglgmgngogpgqgrgsgtgugvgwgxgygzg0g1g2g3g4g5g6g7g8g9g+g/",
+    "hAhBhChDhEhFhGhHhIhJhKhLhMhNhOhPhQhRhShThUhVhWhXhYhZhahbhchdhehfhghhhihjhkhlhmhnhohphqhrhshthuhvhwhxhyhzh0h1h2h3h4h5h6h7h8h9h+h/",
+    "iAiBiCiDiEiFiGiHiIiJiKiLiMiNiOiPiQiRiSiTiUiViWiXiYiZiaibicidieifigihiiijikiliminioipiqirisitiuiviwixiyizi0i1i2i3i4i5i6i7i8i9i+i/",
+    "jAjBjCjDjEjFjGjHjIjJjKjLjMjNjOjPjQjRjSjTjUjVjWjXjYjZjajbjcjdjejfjgjhjijjjkjljmjnjojpjqjrjsjtjujvjwjxjyjzj0j1j2j3j4j5j6j7j8j9j+j/",
+    "kAkBkCkDkEkFkGkHkIkJkKkLkMkNkOkPkQkRkSkTkUkVkWkXkYkZkakbkckdkekfkgkhkikjkkklkmknkokpkqkrksktkukvkwkxkykzk0k1k2k3k4k5k6k7k8k9k+k/",
+    "lAlBlClDlElFlGlHlIlJlKlLlMlNlOlPlQlRlSlTlUlVlWlXlYlZlalblcldlelflglhliljlklllmlnlolplqlrlsltlulvlwlxlylzl0l1l2l3l4l5l6l7l8l9l+l/",
+    "mAmBmCmDmEmFmGmHmImJmKmLmMmNmOmPmQmRmSmTmUmVmWmXmYmZmambmcmdmemfmgmhmimjmkmlmmmnmompmqmrmsmtmumvmwmxmymzm0m1m2m3m4m5m6m7m8m9m+m/",
+    "nAnBnCnDnEnFnGnHnInJnKnLnMnNnOnPnQnRnSnTnUnVnWnXnYnZnanbncndnenfngnhninjnknlnmnnnonpnqnrnsntnunvnwnxnynzn0n1n2n3n4n5n6n7n8n9n+n/",
+    "oAoBoCoDoEoFoGoHoIoJoKoLoMoNoOoPoQoRoSoToUoVoWoXoYoZoaobocodoeofogohoiojokolomonooopoqorosotouovowoxoyozo0o1o2o3o4o5o6o7o8o9o+o/",
+    "pApBpCpDpEpFpGpHpIpJpKpLpMpNpOpPpQpRpSpTpUpVpWpXpYpZpapbpcpdpepfpgphpipjpkplpmpnpopppqprpsptpupvpwpxpypzp0p1p2p3p4p5p6p7p8p9p+p/",
+    "qAqBqCqDqEqFqGqHqIqJqKqLqMqNqOqPqQqRqSqTqUqVqWqXqYqZqaqbqcqdqeqfqgqhqiqjqkqlqmqnqoqpqqqrqsqtquqvqwqxqyqzq0q1q2q3q4q5q6q7q8q9q+q/",
+    "rArBrCrDrErFrGrHrIrJrKrLrMrNrOrPrQrRrSrTrUrVrWrXrYrZrarbrcrdrerfrgrhrirjrkrlrmrnrorprqrrrsrtrurvrwrxryrzr0r1r2r3r4r5r6r7r8r9r+r/",
+    "sAsBsCsDsEsFsGsHsIsJsKsLsMsNsOsPsQsRsSsTsUsVsWsXsYsZsasbscsdsesfsgshsisjskslsmsnsospsqsrssstsusvswsxsyszs0s1s2s3s4s5s6s7s8s9s+s/",
+    "tAtBtCtDtEtFtGtHtItJtKtLtMtNtOtPtQtRtStTtUtVtWtXtYtZtatbtctdtetftgthtitjtktltmtntotptqtrtstttutvtwtxtytzt0t1t2t3t4t5t6t7t8t9t+t/",
+    "uAuBuCuDuEuFuGuHuIuJuKuLuMuNuOuPuQuRuSuTuUuVuWuXuYuZuaubucudueufuguhuiujukulumunuoupuqurusutuuuvuwuxuyuzu0u1u2u3u4u5u6u7u8u9u+u/",
+    "vAvBvCvDvEvFvGvHvIvJvKvLvMvNvOvPvQvRvSvTvUvVvWvXvYvZvavbvcvdvevfvgvhvivjvkvlvmvnvovpvqvrvsvtvuvvvwvxvyvzv0v1v2v3v4v5v6v7v8v9v+v/",
+    "wAwBwCwDwEwFwGwHwIwJwKwLwMwNwOwPwQwRwSwTwUwVwWwXwYwZwawbwcwdwewfwgwhwiwjwkwlwmwnwowpwqwrwswtwuwvwwwxwywzw0w1w2w3w4w5w6w7w8w9w+w/",
+    "xAxBxCxDxExFxGxHxIxJxKxLxMxNxOxPxQxRxSxTxUxVxWxXxYxZxaxbxcxdxexfxgxhxixjxkxlxmxnxoxpxqxrxsxtxuxvxwxxxyxzx0x1x2x3x4x5x6x7x8x9x+x/",
+    "yAyByCyDyEyFyGyHyIyJyKyLyMyNyOyPyQyRySyTyUyVyWyXyYyZyaybycydyeyfygyhyiyjykylymynyoypyqyrysytyuyvywyxyyyzy0y1y2y3y4y5y6y7y8y9y+y/",
+    "zAzBzCzDzEzFzGzHzIzJzKzLzMzNzOzPzQzRzSzTzUzVzWzXzYzZzazbzczdzezfzgzhzizjzkzlzmznzozpzqzrzsztzuzvzwzxzyzzz0z1z2z3z4z5z6z7z8z9z+z/",
+    "0A0B0C0D0E0F0G0H0I0J0K0L0M0N0O0P0Q0R0S0T0U0V0W0X0Y0Z0a0b0c0d0e0f0g0h0i0j0k0l0m0n0o0p0q0r0s0t0u0v0w0x0y0z000102030405060708090+0/",
+    "1A1B1C1D1E1F1G1H1I1J1K1L1M1N1O1P1Q1R1S1T1U1V1W1X1Y1Z1a1b1c1d1e1f1g1h1i1j1k1l1m1n1o1p1q1r1s1t1u1v1w1x1y1z101112131415161718191+1/",
+    "2A2B2C2D2E2F2G2H2I2J2K2L2M2N2O2P2Q2R2S2T2U2V2W2X2Y2Z2a2b2c2d2e2f2g2h2i2j2k2l2m2n2o2p2q2r2s2t2u2v2w2x2y2z202122232425262728292+2/",
+    "3A3B3C3D3E3F3G3H3I3J3K3L3M3N3O3P3Q3R3S3T3U3V3W3X3Y3Z3a3b3c3d3e3f3g3h3i3j3k3l3m3n3o3p3q3r3s3t3u3v3w3x3y3z303132333435363738393+3/",
+    "4A4B4C4D4E4F4G4H4I4J4K4L4M4N4O4P4Q4R4S4T4U4V4W4X4Y4Z4a4b4c4d4e4f4g4h4i4j4k4l4m4n4o4p4q4r4s4t4u4v4w4x4y4z404142434445464748494+4/",
+    "5A5B5C5D5E5F5G5H5I5J5K5L5M5N5O5P5Q5R5S5T5U5V5W5X5Y5Z5a5b5c5d5e5f5g5h5i5j5k5l5m5n5o5p5q5r5s5t5u5v5w5x5y5z505152535455565758595+5/",
+    "6A6B6C6D6E6F6G6H6I6J6K6L6M6N6O6P6Q6R6S6T6U6V6W6X6Y6Z6a6b6c6d6e6f6g6h6i6j6k6l6m6n6o6p6q6r6s6t6u6v6w6x6y6z606162636465666768696+6/",
+    "7A7B7C7D7E7F7G7H7I7J7K7L7M7N7O7P7Q7R7S7T7U7V7W7X7Y7Z7a7b7c7d7e7f7g7h7i7j7k7l7m7n7o7p7q7r7s7t7u7v7w7x7y7z707172737475767778797+7/",
+    "8A8B8C8D8E8F8G8H8I8J8K8L8M8N8O8P8Q8R8S8T8U8V8W8X8Y8Z8a8b8c8d8e8f8g8h8i8j8k8l8m8n8o8p8q8r8s8t8u8v8w8x8y8z808182838485868788898+8/",
+    "9A9B9C9D9E9F9G9H9I9J9K9L9M9N9O9P9Q9R9S9T9U9V9W9X9Y9Z9a9b9c9d9e9f9g9h9i9j9k9l9m9n9o9p9q9r9s9t9u9v9w9x9y9z909192939495969798999+9/",
+    "+A+B+C+D+E+F+G+H+I+J+K+L+M+N+O+P+Q+R+S+T+U+V+W+X+Y+Z+a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p+q+r+s+t+u+v+w+x+y+z+0+1+2+3+4+5+6+7+8+9+++/",
+    "/A/B/C/D/E/F/G/H/I/J/K/L/M/N/O/P/Q/R/S/T/U/V/W/X/Y/Z/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y/z/0/1/2/3/4/5/6/7/8/9/+//"
+} };
+
+static inline const char* pair(uint32_t bits12) {
+    return BASE64_PAIRS.flat + bits12 * 2;
+}
+
+static inline uint64_t load_be64(const uint8_t* p) {
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+           ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+           ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
 size_t basex_base64_encode_len(size_t input_len) {
     return ((input_len + 2) / 3) * 4;
 }
@@ -40,17 +144,30 @@ ssize_t basex_base64_encode(const uint8_t* input, size_t input_len, char* output
     if (!input || !output) return -1;
     
     size_t out_pos = 0;
-    size_t i;
+    size_t i = 0;
     
-    for (i = 0; i + 2 < input_len; i += 3) {
+    i = basex_kernels()->base64.encode(input, input_len, output);
+    out_pos = (i / 3) * 4;
+    
+    // 8-byte loads, 6 bytes -> four 12-bit pair lookups
+    for (; i + 8 <= input_len; i += 6) {
+        uint64_t word = load_be64(input + i);
+        
+        memcpy(output + out_pos,     pair((word >> 52) & 0xFFF), 2);
+        memcpy(output + out_pos + 2, pair((word >> 40) & 0xFFF), 2);
+        memcpy(output + out_pos + 4, pair((word >> 28) & 0xFFF), 2);
+        memcpy(output + out_pos + 6, pair((word >> 16) & 0xFFF), 2);
+        out_pos += 8;
+    }
+    
+    for (; i + 2 < input_len; i += 3) {
         uint32_t value = ((uint32_t)input[i] << 16) |
                         ((uint32_t)input[i+1] << 8) |
                         ((uint32_t)input[i+2]);
         
-        output[out_pos++] = BASE64_ALPHABET[(value >> 18) & 0x3F];
-        output[out_pos++] = BASE64_ALPHABET[(value >> 12) & 0x3F];
-        output[out_pos++] = BASE64_ALPHABET[(value >> 6) & 0x3F];
-        output[out_pos++] = BASE64_ALPHABET[value & 0x3F];
+        memcpy(output + out_pos,     pair(value >> 12), 2);
+        memcpy(output + out_pos + 2, pair(value & 0xFFF), 2);
+        out_pos += 4;
     }
     
     if (i < input_len) {
@@ -69,15 +186,59 @@ ssize_t basex_base64_encode(const uint8_t* input, size_t input_len, char* output
 ssize_t basex_base64_decode(const char* input, size_t input_len, uint8_t* output) {
     if (!input || !output) return -1;
     
+    basex_stream_t stream = { .codec = BASEX_CODEC_BASE64, .decode = true };
+    return basex_base64_stream_decode(&stream, input, input_len, output);
+}
+
+ssize_t basex_base64_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output) {
     size_t out_pos = 0;
-    uint32_t value = 0;
-    int bits = 0;
+    uint32_t value = (uint32_t)stream->accumulator;
+    int bits = (int)stream->bits;
+    bool kernel_run = false;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
-        if (input[i] == '=') break;
+    if (stream->done) return 0;
+    
+    while (i < input_len) {
+        if (bits == 0) {
+            // The block kernel starts on a group boundary, which a stream
+            // reaches again within a few characters
+            if (!kernel_run) {
+                size_t written = 0;
+                i += basex_kernels()->base64.decode(input + i, input_len - i, output + out_pos,
+                                                    &written);
+                out_pos += written;
+                kernel_run = true;
+            }
+            
+            // Whole quads of valid characters, one sentinel check per quad
+            for (; i + 4 <= input_len; i += 4) {
+                uint32_t quad = BASE64_DECODE_QUAD[0][(uint8_t)input[i]] |
+                                BASE64_DECODE_QUAD[1][(uint8_t)input[i+1]] |
+                                BASE64_DECODE_QUAD[2][(uint8_t)input[i+2]] |
+                                BASE64_DECODE_QUAD[3][(uint8_t)input[i+3]];
+                if (quad & BASE64_BAD) break;
+                
+                output[out_pos++] = (quad >> 16) & 0xFF;
+                output[out_pos++] = (quad >> 8) & 0xFF;
+                output[out_pos++] = quad & 0xFF;
+            }
+            if (i >= input_len) break;
+        }
         
-        int8_t c = BASE64_DECODE_TABLE[(uint8_t)input[i]];
-        if (c < 0) continue;
+        // One character at a time around padding and non-alphabet bytes
+        if (input[i] == '=') {
+            stream->done = true;
+            break;
+        }
+        
+        int8_t c = BASE64_DECODE_TABLE[(uint8_t)input[i++]];
+        if (c < 0) {
+            // Whitespace was dropped in front of the core; anything else is garbage
+            if (stream->skip == BASEX_SKIP_WHITESPACE) return -1;
+            continue;
+        }
         
         value = (value << 6) | c;
         bits += 6;
@@ -88,5 +249,21 @@ ssize_t basex_base64_decode(const char* input, size_t input_len, uint8_t* output
         }
     }
     
+    stream->accumulator = value & ((1u << bits) - 1);
+    stream->bits = (unsigned)bits;
     return out_pos;
 }
+
+size_t basex_base64_count_symbols(const char* input, size_t input_len, size_t limit,
+                                  size_t* consumed) {
+    size_t count = 0;
+    size_t i = 0;
+    
+    for (; i < input_len && count < limit; i++) {
+        if (input[i] == '=') break;
+        count += BASE64_DECODE_TABLE[(uint8_t)input[i]] >= 0;
+    }
+    
+    *consumed = i;
+    return count;
+}
@@ -1,4 +1,7 @@
 #include "../../include/basex.h"
+#include "dispatch.h"
+#include "stream.h"
+#include <pthread.h>
 #include <string.h>
 
 // Base85 encoding (RFC 1924) - Portable implementation
@@ -29,6 +32,30 @@ static const int8_t BASE85_DECODE_TABLE[256] = {
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
 };
 
+// Two-digit tables, built on first use:
+// - both characters of every value 0..7224 (85^2 - 1)
+// - d0 * 85 + d1 for every pair of 7-bit characters, BASE85_BAD if either
+//   one is outside the alphabet
+#define BASE85_BAD 0x8000
+static char BASE85_PAIRS[85 * 85][2];
+static uint16_t BASE85_PAIR_VALUES[128 * 128];
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+static void init_tables(void) {
+    for (int v = 0; v < 85 * 85; v++) {
+        BASE85_PAIRS[v][0] = BASE85_ALPHABET[v / 85];
+        BASE85_PAIRS[v][1] = BASE85_ALPHABET[v % 85];
+    }
+    for (int c0 = 0; c0 < 128; c0++) {
+        for (int c1 = 0; c1 < 128; c1++) {
+            int8_t d0 = BASE85_DECODE_TABLE[c0];
+            int8_t d1 = BASE85_DECODE_TABLE[c1];
+            BASE85_PAIR_VALUES[c0 << 7 | c1] =
+                (d0 < 0 || d1 < 0) ? BASE85_BAD : (uint16_t)(d0 * 85 + d1);
+        }
+    }
+}
+
 size_t basex_base85_encode_len(size_t input_len) {
     return ((input_len + 3) / 4) * 5;
 }
@@ -41,21 +68,30 @@ ssize_t basex_base85_encode(const uint8_t* input, size_t input_len, char* output
     if (!input || !output) return -1;
     
     size_t out_pos = 0;
-    size_t i;
+    size_t i = 0;
+    
+    pthread_once(&tables_once, init_tables);
+    
+    i = basex_kernels()->base85.encode(input, input_len, output);
+    out_pos = (i / 4) * 5;
     
     // Process full 4-byte blocks
-    for (i = 0; i + 3 < input_len; i += 4) {
+    for (; i + 3 < input_len; i += 4) {
         uint32_t value = ((uint32_t)input[i] << 24) |
                         ((uint32_t)input[i+1] << 16) |
                         ((uint32_t)input[i+2] << 8) |
                         ((uint32_t)input[i+3]);
         
-        // Encode as 5 base85 digits
-        output[out_pos + 4] = BASE85_ALPHABET[value % 85]; value /= 85;
-        output[out_pos + 3] = BASE85_ALPHABET[value % 85]; value /= 85;
-        output[out_pos + 2] = BASE85_ALPHABET[value % 85]; value /= 85;
-        output[out_pos + 1] = BASE85_ALPHABET[value % 85]; value /= 85;
-        output[out_pos + 0] = BASE85_ALPHABET[value];
+        // Split into d0 | (d1 d2) | (d3 d4): two constant divisions (which
+        // compile to multiply-high) instead of a chain of four
+        uint32_t upper = value / (85 * 85);     // d0 d1 d2
+        uint32_t d0 = upper / (85 * 85);
+        uint32_t mid = upper - d0 * (85 * 85);  // d1 d2
+        uint32_t low = value - upper * (85 * 85); // d3 d4
+        
+        output[out_pos] = BASE85_ALPHABET[d0];
+        memcpy(output + out_pos + 1, BASE85_PAIRS[mid], 2);
+        memcpy(output + out_pos + 3, BASE85_PAIRS[low], 2);
         
         out_pos += 5;
     }
@@ -85,19 +121,27 @@ ssize_t basex_base85_decode(const char* input, size_t input_len, uint8_t* output
     if (!input || !output) return -1;
     
     size_t out_pos = 0;
-    size_t i;
+    size_t i = 0;
+    
+    pthread_once(&tables_once, init_tables);
+    
+    i = basex_kernels()->base85.decode(input, input_len, output, &out_pos);
     
     // Process full 5-character blocks
-    for (i = 0; i + 4 < input_len; i += 5) {
-        uint32_t value = 0;
+    for (; i + 4 < input_len; i += 5) {
+        const uint8_t* c = (const uint8_t*)input + i;
         
-        // Decode 5 base85 digits
-        for (int j = 0; j < 5; j++) {
-            int8_t digit = BASE85_DECODE_TABLE[(uint8_t)input[i + j]];
-            if (digit < 0) return -1; // Invalid character
-            value = value * 85 + digit;
+        // Two pair lookups and one digit instead of five chained steps
+        uint32_t hi = BASE85_PAIR_VALUES[(c[0] & 0x7F) << 7 | (c[1] & 0x7F)];
+        uint32_t mid = BASE85_PAIR_VALUES[(c[2] & 0x7F) << 7 | (c[3] & 0x7F)];
+        int8_t last = BASE85_DECODE_TABLE[c[4]];
+        if (((hi | mid) & BASE85_BAD) || ((c[0] | c[1] | c[2] | c[3]) & 0x80) || last < 0) {
+            return -1; // Invalid character
         }
         
+        uint64_t value = (uint64_t)hi * (85 * 85 * 85) + mid * 85 + (uint32_t)last;
+        if (value > UINT32_MAX) return -1; // Not produced by any 4-byte block
+        
         // Output 4 bytes
         output[out_pos++] = (value >> 24) & 0xFF;
         output[out_pos++] = (value >> 16) & 0xFF;
@@ -125,3 +169,7 @@ ssize_t basex_base85_decode(const char* input, size_t input_len, uint8_t* output
     
     return out_pos;
 }
+
+bool basex_base85_is_symbol(uint8_t c) {
+    return BASE85_DECODE_TABLE[c] >= 0;
+}
@@ -1,4 +1,8 @@
 #include "../../include/basex.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include "stream.h"
+#include <pthread.h>
 #include <string.h>
 
 // Base91 encoding - Portable implementation
@@ -29,6 +33,36 @@ static const int8_t BASE91_DECODE_TABLE[256] = {
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
 };
 
+// Pair tables, built on first use:
+// - both characters of every value 0..8280; a 14-bit value only occurs
+//   when its low 13 bits are <= 88, so no value reaches 91 * 91
+// - the value of every pair of 7-bit characters, with PAIR_WIDE set when
+//   it carries 14 bits and PAIR_BAD when either character is invalid
+#define PAIR_WIDE 0x4000
+#define PAIR_BAD 0x8000
+static char BASE91_PAIRS[91 * 91][2];
+static uint16_t BASE91_PAIR_VALUES[128 * 128];
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+static void init_tables(void) {
+    for (int v = 0; v < 91 * 91; v++) {
+        BASE91_PAIRS[v][0] = BASE91_ALPHABET[v % 91];
+        BASE91_PAIRS[v][1] = BASE91_ALPHABET[v / 91];
+    }
+    for (int c0 = 0; c0 < 128; c0++) {
+        for (int c1 = 0; c1 < 128; c1++) {
+            int8_t lo = BASE91_DECODE_TABLE[c0];
+            int8_t hi = BASE91_DECODE_TABLE[c1];
+            uint16_t entry = PAIR_BAD;
+            if (lo >= 0 && hi >= 0) {
+                entry = (uint16_t)(lo + hi * 91);
+                if ((entry & 0x1FFF) <= 88) entry |= PAIR_WIDE;
+            }
+            BASE91_PAIR_VALUES[c0 | c1 << 7] = entry;
+        }
+    }
+}
+
 size_t basex_base91_encode_len(size_t input_len) {
     // Worst case: each byte becomes ~1.23 characters
     return input_len + (input_len / 4) + 4;
@@ -39,83 +73,216 @@ size_t basex_base91_decode_len(size_t input_len) {
     return input_len + 4;
 }
 
+// Take 13 bits, or 14 when the low 13 are <= 88, and write them as a pair
+static inline void encode_pair(uint64_t* acc, unsigned* bits, char* output) {
+    unsigned width = 13 + ((*acc & 0x1FFF) <= 88);
+    uint32_t value = (uint32_t)*acc & ((1u << width) - 1);
+    *acc >>= width;
+    *bits -= width;
+    memcpy(output, BASE91_PAIRS[value], 2);
+}
+
 ssize_t basex_base91_encode(const uint8_t* input, size_t input_len, char* output) {
     if (!input || !output) return -1;
     
-    uint32_t accumulator = 0;
-    int bits = 0;
+    basex_stream_t stream = { .codec = BASEX_CODEC_BASE91, .pending = -1 };
+    ssize_t out_pos = basex_base91_stream_encode(&stream, input, input_len, output);
+    return out_pos + (ssize_t)basex_base91_stream_encode_final(&stream, output + out_pos);
+}
+
+ssize_t basex_base91_stream_encode(basex_stream_t* stream, const uint8_t* input, size_t input_len,
+                                   char* output) {
+    uint64_t accumulator = stream->accumulator;
+    unsigned bits = stream->bits;
     size_t out_pos = 0;
+    size_t i = 0;
+    
+    pthread_once(&tables_once, init_tables);
+    
+    // Refill 6-7 bytes at a time and drain every full pair. The pairs only
+    // depend on the bit stream, so this matches the byte-wise loop below.
+    for (; i + 8 <= input_len; ) {
+        unsigned take = (63 - bits) >> 3;
+        uint64_t word = 0;
+        for (unsigned k = 0; k < take; k++) {
+            word |= (uint64_t)input[i + k] << (8 * k);
+        }
+        accumulator |= word << bits;
+        bits += take * 8;
+        i += take;
+        
+        while (bits > 13) {
+            encode_pair(&accumulator, &bits, output + out_pos);
+            out_pos += 2;
+        }
+    }
     
-    for (size_t i = 0; i < input_len; i++) {
-        accumulator |= (uint32_t)input[i] << bits;
+    for (; i < input_len; i++) {
+        accumulator |= (uint64_t)input[i] << bits;
         bits += 8;
         
         if (bits > 13) {
-            uint32_t value = accumulator & 0x1FFF; // 13 bits
-            
-            if (value > 88) {
-                accumulator >>= 13;
-                bits -= 13;
-            } else {
-                value = accumulator & 0x3FFF; // 14 bits
-                accumulator >>= 14;
-                bits -= 14;
-            }
-            
-            output[out_pos++] = BASE91_ALPHABET[value % 91];
-            output[out_pos++] = BASE91_ALPHABET[value / 91];
+            encode_pair(&accumulator, &bits, output + out_pos);
+            out_pos += 2;
         }
     }
     
+    stream->accumulator = accumulator;
+    stream->bits = bits;
+    return out_pos;
+}
+
+size_t basex_base91_stream_encode_final(basex_stream_t* stream, char* output) {
+    uint64_t accumulator = stream->accumulator;
+    size_t out_pos = 0;
+    
+    pthread_once(&tables_once, init_tables);
+    
     // Flush remaining bits
-    if (bits > 0) {
-        output[out_pos++] = BASE91_ALPHABET[accumulator % 91];
-        if (bits > 7 || accumulator > 90) {
-            output[out_pos++] = BASE91_ALPHABET[accumulator / 91];
+    if (stream->bits > 0) {
+        output[out_pos++] = BASE91_PAIRS[accumulator][0];
+        if (stream->bits > 7 || accumulator > 90) {
+            output[out_pos++] = BASE91_PAIRS[accumulator][1];
         }
     }
     
+    stream->accumulator = 0;
+    stream->bits = 0;
     return out_pos;
 }
 
+// Table entry for a character pair, PAIR_BAD if either one is invalid
+static inline uint32_t pair_entry(const char* input) {
+    uint8_t c0 = (uint8_t)input[0];
+    uint8_t c1 = (uint8_t)input[1];
+    if ((c0 | c1) & 0x80) return PAIR_BAD;
+    return BASE91_PAIR_VALUES[c0 | c1 << 7];
+}
+
 ssize_t basex_base91_decode(const char* input, size_t input_len, uint8_t* output) {
     if (!input || !output) return -1;
     
-    uint32_t accumulator = 0;
-    int bits = 0;
-    int value = -1;
+    basex_stream_t stream = { .codec = BASEX_CODEC_BASE91, .decode = true, .pending = -1 };
+    ssize_t out_pos = basex_base91_stream_decode(&stream, input, input_len, output);
+    if (out_pos < 0) return -1;
+    return out_pos + (ssize_t)basex_base91_stream_decode_final(&stream, output + out_pos);
+}
+
+ssize_t basex_base91_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output) {
+    uint64_t accumulator = stream->accumulator;
+    unsigned bits = stream->bits;
     size_t out_pos = 0;
+    size_t i = 0;
     
-    for (size_t i = 0; i < input_len; i++) {
-        int8_t c = BASE91_DECODE_TABLE[(uint8_t)input[i]];
+    pthread_once(&tables_once, init_tables);
+    
+    // Complete a pair split by the previous call
+    if (stream->pending >= 0 && input_len > 0) {
+        int8_t c = BASE91_DECODE_TABLE[(uint8_t)input[0]];
         if (c < 0) return -1; // Invalid character
         
-        if (value < 0) {
-            value = c;
-        } else {
-            value += c * 91;
-            accumulator |= value << bits;
-            
-            if ((value & 0x1FFF) > 88) {
-                bits += 13;
-            } else {
-                bits += 14;
-            }
-            
-            while (bits > 7) {
-                output[out_pos++] = accumulator & 0xFF;
-                accumulator >>= 8;
-                bits -= 8;
-            }
-            
-            value = -1;
+        uint32_t value = (uint32_t)(stream->pending + c * 91);
+        accumulator |= (uint64_t)value << bits;
+        bits += (value & 0x1FFF) > 88 ? 13 : 14;
+        stream->pending = -1;
+        i = 1;
+    }
+    
+    // The block kernel starts on a byte boundary; carried bits usually run
+    // out within a few pairs
+    while (bits > 7) {
+        output[out_pos++] = accumulator & 0xFF;
+        accumulator >>= 8;
+        bits -= 8;
+    }
+    for (int k = 0; k < 64 && bits != 0 && i + 1 < input_len; k++, i += 2) {
+        uint32_t entry = pair_entry(input + i);
+        if (entry & PAIR_BAD) return -1; // Invalid character
+        
+        accumulator |= (uint64_t)(entry & 0x3FFF) << bits;
+        bits += 13 + ((entry & PAIR_WIDE) != 0);
+        
+        while (bits > 7) {
+            output[out_pos++] = accumulator & 0xFF;
+            accumulator >>= 8;
+            bits -= 8;
+        }
+    }
+    
+    if (bits == 0) {
+        size_t written = 0;
+        i += basex_kernels()->base91.decode(input + i, input_len - i, output + out_pos, &written);
+        out_pos += written;
+    }
+    
+    // One lookup per pair; 32 bits are written at a time
+    for (; i + 1 < input_len; i += 2) {
+        uint32_t entry = pair_entry(input + i);
+        if (entry & PAIR_BAD) return -1; // Invalid character
+        
+        accumulator |= (uint64_t)(entry & 0x3FFF) << bits;
+        bits += 13 + ((entry & PAIR_WIDE) != 0);
+        
+        if (bits >= 32) {
+            output[out_pos] = (uint8_t)accumulator;
+            output[out_pos + 1] = (uint8_t)(accumulator >> 8);
+            output[out_pos + 2] = (uint8_t)(accumulator >> 16);
+            output[out_pos + 3] = (uint8_t)(accumulator >> 24);
+            out_pos += 4;
+            accumulator >>= 32;
+            bits -= 32;
         }
     }
     
+    while (bits > 7) {
+        output[out_pos++] = accumulator & 0xFF;
+        accumulator >>= 8;
+        bits -= 8;
+    }
+    
+    // Hold an odd character for the next call or the final flush
+    if (i < input_len) {
+        int8_t c = BASE91_DECODE_TABLE[(uint8_t)input[i]];
+        if (c < 0) return -1; // Invalid character
+        stream->pending = c;
+    }
+    
+    stream->accumulator = accumulator;
+    stream->bits = bits;
+    return out_pos;
+}
+
+size_t basex_base91_stream_decode_final(basex_stream_t* stream, uint8_t* output) {
+    size_t out_pos = 0;
+    
     // Flush remaining bits
-    if (value >= 0) {
-        output[out_pos++] = (accumulator | (value << bits)) & 0xFF;
+    if (stream->pending >= 0) {
+        output[out_pos++] = (stream->accumulator | ((uint64_t)stream->pending << stream->bits)) & 0xFF;
     }
     
+    stream->accumulator = 0;
+    stream->bits = 0;
+    stream->pending = -1;
     return out_pos;
 }
+
+int64_t basex_base91_count_bits(const char* input, size_t input_len) {
+    uint32_t flags = 0;
+    uint64_t wide = 0;
+    
+    pthread_once(&tables_once, init_tables);
+    
+    for (size_t i = 0; i + 1 < input_len; i += 2) {
+        uint32_t entry = pair_entry(input + i);
+        flags |= entry;
+        wide += (entry & PAIR_WIDE) != 0;
+    }
+    if (flags & PAIR_BAD) return -1; // Invalid character
+    
+    return (int64_t)(input_len / 2 * 13 + wide);
+}
+
+bool basex_base91_is_symbol(uint8_t c) {
+    return BASE91_DECODE_TABLE[c] >= 0;
+}
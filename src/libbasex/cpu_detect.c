@@ -1,12 +1,25 @@
 #include "../include/basex.h"
 #include <stdio.h>
 #include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
 #include <cpuid.h>
 
+// Read XCR0 to see which register states the OS saves on context switch
+static uint64_t read_xcr0(void) {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
+
 basex_cpu_features_t basex_detect_cpu_features(void) {
     basex_cpu_features_t features = {0};
     
+#if defined(__x86_64__) || defined(__i386__)
     unsigned int eax, ebx, ecx, edx;
+    bool os_avx = false;
+    bool os_avx512 = false;
     
     // Get CPU vendor and model name
     if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000004) {
@@ -24,17 +37,35 @@ basex_cpu_features_t basex_detect_cpu_features(void) {
         }
     }
     
-    // Check for SSE4.2 (CPUID.01H:ECX.SSE42[bit 20])
+    // Check for SSSE3 (CPUID.01H:ECX[bit 9]), SSE4.1 [bit 19], SSE4.2 [bit 20]
     if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        features.has_ssse3 = (ecx & (1 << 9)) != 0;
+        features.has_sse41 = (ecx & (1 << 19)) != 0;
         features.has_sse42 = (ecx & (1 << 20)) != 0;
+        
+        // YMM state must be enabled by the OS (OSXSAVE[bit 27], AVX[bit 28],
+        // XCR0 bits 1-2), otherwise AVX2 instructions fault
+        if ((ecx & (1 << 27)) && (ecx & (1 << 28))) {
+            uint64_t xcr0 = read_xcr0();
+            os_avx = (xcr0 & 0x6) == 0x6;
+            // ZMM state additionally needs opmask and upper ZMM (bits 5-7)
+            os_avx512 = (xcr0 & 0xE6) == 0xE6;
+        }
     }
     
     // Check for AVX2 (CPUID.07H:EBX.AVX2[bit 5])
     if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
-        features.has_avx2 = (ebx & (1 << 5)) != 0;
+        features.has_avx2 = os_avx && (ebx & (1 << 5)) != 0;
         features.has_bmi1 = (ebx & (1 << 3)) != 0;
         features.has_bmi2 = (ebx & (1 << 8)) != 0;
+        
+        // AVX-512 F[16], BW[30], VL[31] in EBX; VBMI[1] in ECX
+        features.has_avx512f = os_avx512 && (ebx & (1 << 16)) != 0;
+        features.has_avx512bw = os_avx512 && (ebx & (1 << 30)) != 0;
+        features.has_avx512vl = os_avx512 && (ebx & (1u << 31)) != 0;
+        features.has_avx512vbmi = os_avx512 && (ecx & (1 << 1)) != 0;
     }
+#endif
     
     return features;
 }
@@ -47,14 +78,21 @@ void basex_print_cpu_info(void) {
     printf("=====================================\n");
     printf("CPU Model: %s\n", features.cpu_name[0] ? features.cpu_name : "Unknown");
     printf("\nSupported Features:\n");
-    printf("  SSE4.2:  %s\n", features.has_sse42 ? "✓ Yes" : "✗ No");
-    printf("  AVX2:    %s\n", features.has_avx2 ? "✓ Yes" : "✗ No");
-    printf("  BMI1:    %s\n", features.has_bmi1 ? "✓ Yes" : "✗ No");
-    printf("  BMI2:    %s\n", features.has_bmi2 ? "✓ Yes" : "✗ No");
+    printf("  SSSE3:       %s\n", features.has_ssse3 ? "✓ Yes" : "✗ No");
+    printf("  SSE4.1:      %s\n", features.has_sse41 ? "✓ Yes" : "✗ No");
+    printf("  SSE4.2:      %s\n", features.has_sse42 ? "✓ Yes" : "✗ No");
+    printf("  AVX2:        %s\n", features.has_avx2 ? "✓ Yes" : "✗ No");
+    printf("  BMI1:        %s\n", features.has_bmi1 ? "✓ Yes" : "✗ No");
+    printf("  BMI2:        %s\n", features.has_bmi2 ? "✓ Yes" : "✗ No");
+    printf("  AVX512F:     %s\n", features.has_avx512f ? "✓ Yes" : "✗ No");
+    printf("  AVX512BW:    %s\n", features.has_avx512bw ? "✓ Yes" : "✗ No");
+    printf("  AVX512VL:    %s\n", features.has_avx512vl ? "✓ Yes" : "✗ No");
+    printf("  AVX512VBMI:  %s\n", features.has_avx512vbmi ? "✓ Yes" : "✗ No");
     printf("\nOptimization Status:\n");
     
-    if (features.has_avx2 && features.has_bmi2) {
-        printf("  Using SIMD-accelerated code paths (AVX2+BMI2)\n");
+    basex_isa_t isa = basex_active_isa();
+    if (isa != BASEX_ISA_PORTABLE) {
+        printf("  Using SIMD-accelerated code paths (%s)\n", basex_isa_name(isa));
         printf("  Expected performance: 5-8 GB/s\n");
     } else {
         printf("  Using portable code paths\n");
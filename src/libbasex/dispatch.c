@@ -0,0 +1,158 @@
+#include "../../include/basex.h"
+#include "dispatch.h"
+#include "simd/simd.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <strings.h>
+
+// Runtime kernel selection
+// Resolved once per process from CPUID + OS state; BASEX_FORCE_ISA can
+// lower the tier so each one can be benchmarked on the same machine.
+
+static const char* const ISA_NAMES[BASEX_ISA_COUNT] = {
+    "portable",
+    "bmi2",
+    "sse41",
+    "avx2",
+    "avx512vbmi"
+};
+
+static basex_kernels_t kernels;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+// Portable tier: no block kernel, the codec loops do all the work
+static size_t encode_none(const uint8_t* input, size_t input_len, char* output) {
+    (void)input; (void)input_len; (void)output;
+    return 0;
+}
+
+static size_t decode_none(const char* input, size_t input_len, uint8_t* output,
+                          size_t* output_len) {
+    (void)input; (void)input_len; (void)output;
+    *output_len = 0;
+    return 0;
+}
+
+static bool isa_supported(basex_isa_t isa, const basex_cpu_features_t* features) {
+    (void)features; // Unused when every SIMD tier is compiled out
+    switch (isa) {
+    case BASEX_ISA_PORTABLE:
+        return true;
+#ifdef HAVE_BMI
+    case BASEX_ISA_BMI2:
+        return features->has_bmi2;
+#endif
+#ifdef HAVE_SSE41
+    case BASEX_ISA_SSE41:
+        return features->has_ssse3 && features->has_sse41;
+#endif
+#ifdef HAVE_AVX2
+    case BASEX_ISA_AVX2:
+        return features->has_avx2;
+#endif
+#ifdef HAVE_AVX512VBMI
+    case BASEX_ISA_AVX512VBMI:
+        return features->has_avx2 && features->has_avx512f && features->has_avx512bw &&
+               features->has_avx512vl && features->has_avx512vbmi;
+#endif
+    default:
+        return false;
+    }
+}
+
+// Tiers are not strictly nested (SSE4.1 hosts may lack BMI2), so walk
+// down from the requested tier to the first one the CPU can run
+static basex_isa_t best_supported_isa(basex_isa_t from, const basex_cpu_features_t* features) {
+    int isa = from;
+    while (isa > BASEX_ISA_PORTABLE && !isa_supported((basex_isa_t)isa, features)) {
+        isa--;
+    }
+    return (basex_isa_t)isa;
+}
+
+static basex_isa_t select_isa(const basex_cpu_features_t* features) {
+    const char* forced = getenv("BASEX_FORCE_ISA");
+
+    if (forced && *forced) {
+        for (int isa = 0; isa < BASEX_ISA_COUNT; isa++) {
+            if (strcasecmp(forced, ISA_NAMES[isa]) == 0) {
+                // Never go above what the CPU can run
+                return best_supported_isa((basex_isa_t)isa, features);
+            }
+        }
+    }
+    return best_supported_isa((basex_isa_t)(BASEX_ISA_COUNT - 1), features);
+}
+
+static void resolve_kernels(void) {
+    const basex_codec_kernels_t none = { encode_none, decode_none, encode_none, decode_none };
+    basex_kernels_t k = { BASEX_ISA_PORTABLE, none, none, none, none, none };
+    basex_cpu_features_t features = basex_detect_cpu_features();
+
+    k.isa = select_isa(&features);
+
+#ifdef HAVE_BMI
+    // Scalar PDEP/PEXT kernels: the whole fast path on the bmi2 tier, and
+    // the tail handler after the vector kernels above it
+    if (k.isa >= BASEX_ISA_BMI2 && features.has_bmi2) {
+        k.base32.encode_tail = basex_base32_encode_bmi2;
+        k.base122.encode_tail = basex_base122_encode_bmi2;
+        k.base122.decode_tail = basex_base122_decode_bmi2;
+    }
+#endif
+
+#ifdef HAVE_SSE41
+    if (k.isa >= BASEX_ISA_SSE41) {
+        k.base32.encode = basex_base32_encode_sse41;
+        k.base32.decode = basex_base32_decode_sse41;
+        k.base64.encode = basex_base64_encode_sse41;
+        k.base64.decode = basex_base64_decode_sse41;
+        k.base85.encode = basex_base85_encode_sse41;
+        k.base85.decode = basex_base85_decode_sse41;
+        k.base91.decode = basex_base91_decode_sse41;
+        k.base122.encode = basex_base122_encode_sse41;
+        k.base122.decode = basex_base122_decode_sse41;
+    }
+#endif
+
+#ifdef HAVE_AVX2
+    if (k.isa >= BASEX_ISA_AVX2) {
+        k.base32.encode = basex_base32_encode_avx2;
+        k.base32.decode = basex_base32_decode_avx2;
+        k.base64.encode = basex_base64_encode_avx2;
+        k.base64.decode = basex_base64_decode_avx2;
+        k.base85.encode = basex_base85_encode_avx2;
+        k.base85.decode = basex_base85_decode_avx2;
+        k.base91.decode = basex_base91_decode_avx2;
+        k.base122.encode = basex_base122_encode_avx2;
+        k.base122.decode = basex_base122_decode_avx2;
+    }
+#endif
+
+#ifdef HAVE_AVX512VBMI
+    // Codecs without an AVX-512 kernel keep their AVX2 one
+    if (k.isa >= BASEX_ISA_AVX512VBMI) {
+        k.base32.encode = basex_base32_encode_avx512;
+        k.base32.decode = basex_base32_decode_avx512;
+        k.base64.encode = basex_base64_encode_avx512;
+        k.base64.decode = basex_base64_decode_avx512;
+    }
+#endif
+
+    kernels = k;
+}
+
+const basex_kernels_t* basex_kernels(void) {
+    pthread_once(&kernels_once, resolve_kernels);
+    return &kernels;
+}
+
+basex_isa_t basex_active_isa(void) {
+    return basex_kernels()->isa;
+}
+
+const char* basex_isa_name(basex_isa_t isa) {
+    if ((int)isa < 0 || isa >= BASEX_ISA_COUNT) return "unknown";
+    return ISA_NAMES[isa];
+}
@@ -0,0 +1,38 @@
+// Runtime kernel dispatch
+// Every codec has a pair of block kernels that process as much input as
+// they can and return the number of input bytes consumed (decoders also
+// report the bytes written). The portable loops in each codec handle
+// whatever is left. Tail kernels run on what the block kernel left over,
+// before the portable loop.
+
+#ifndef BASEX_DISPATCH_H
+#define BASEX_DISPATCH_H
+
+#include "../../include/basex.h"
+
+typedef size_t (*basex_encode_kernel_t)(const uint8_t* input, size_t input_len, char* output);
+typedef size_t (*basex_decode_kernel_t)(const char* input, size_t input_len, uint8_t* output,
+                                        size_t* output_len);
+
+typedef struct {
+    basex_encode_kernel_t encode;
+    basex_decode_kernel_t decode;
+    basex_encode_kernel_t encode_tail;
+    basex_decode_kernel_t decode_tail;
+} basex_codec_kernels_t;
+
+typedef struct {
+    basex_isa_t isa;
+    basex_codec_kernels_t base32;
+    basex_codec_kernels_t base64;
+    basex_codec_kernels_t base85;
+    basex_codec_kernels_t base91;
+    basex_codec_kernels_t base122;
+} basex_kernels_t;
+
+/**
+ * Get the kernel table for this CPU (resolved once, thread-safe)
+ */
+const basex_kernels_t* basex_kernels(void);
+
+#endif /* BASEX_DISPATCH_H */
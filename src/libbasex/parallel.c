@@ -0,0 +1,431 @@
+#define _DEFAULT_SOURCE // sysconf(_SC_NPROCESSORS_ONLN)
+
+#include "../../include/basex.h"
+#include "parallel.h"
+#include "stream.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+// Parallel encoding/decoding
+// Block codecs turn every whole input block into a fixed number of output
+// bytes, so a buffer split on block boundaries is coded piece by piece on
+// separate threads, each writing straight to its final offset. The kernels
+// store exactly the bytes they produce, so pieces never overlap, and the
+// result is identical to the one-shot functions.
+//
+// Base91 and Base122 decode in three passes instead: count the bits of
+// each piece, turn the counts into output bit offsets, then decode each
+// piece from its offset and merge the bytes shared at piece boundaries.
+
+#define MAX_THREADS 64
+#define MIN_PIECE (256 * 1024) // Smaller pieces cost more to hand off than to code
+
+// The Base91/Base122 kernels may store up to 8 bytes past their output.
+// A piece decodes its first HEAD_CHARS characters (at least 28 bytes)
+// aside, and they are copied in once the piece before it is done.
+#define HEAD_CHARS 64
+
+typedef struct {
+    basex_codec_t codec;
+    bool decode;
+    const uint8_t* input;
+    size_t input_len;
+    uint8_t* output;
+    ssize_t result;
+    size_t symbols;  // count_job: alphabet characters before any '='
+    size_t consumed; // count_job: position of the '=', or input_len
+    uint64_t bits;   // width_job: output bits of the piece
+    basex_stream_t stream;          // stream_job: decoder state, starting mid-byte
+    uint8_t head[HEAD_CHARS + 16];  // stream_job: output of the first characters
+    size_t head_len;
+} job_t;
+
+static void* code_job(void* arg) {
+    job_t* job = arg;
+    const char* text = (const char*)job->input;
+    char* out_text = (char*)job->output;
+
+    switch (job->codec) {
+        case BASEX_CODEC_BASE32:
+            job->result = job->decode
+                ? basex_base32_decode(text, job->input_len, job->output)
+                : basex_base32_encode(job->input, job->input_len, out_text);
+            break;
+        case BASEX_CODEC_BASE64:
+            job->result = job->decode
+                ? basex_base64_decode(text, job->input_len, job->output)
+                : basex_base64_encode(job->input, job->input_len, out_text);
+            break;
+        case BASEX_CODEC_BASE85:
+            job->result = job->decode
+                ? basex_base85_decode(text, job->input_len, job->output)
+                : basex_base85_encode(job->input, job->input_len, out_text);
+            break;
+        case BASEX_CODEC_BASE122:
+            job->result = job->decode ? -1
+                : basex_base122_encode(job->input, job->input_len, out_text);
+            break;
+        default:
+            job->result = -1;
+            break;
+    }
+    return NULL;
+}
+
+static size_t count_symbols(basex_codec_t codec, const uint8_t* input, size_t input_len,
+                            size_t limit, size_t* consumed) {
+    return codec == BASEX_CODEC_BASE32
+        ? basex_base32_count_symbols((const char*)input, input_len, limit, consumed)
+        : basex_base64_count_symbols((const char*)input, input_len, limit, consumed);
+}
+
+static void* count_job(void* arg) {
+    job_t* job = arg;
+    job->symbols = count_symbols(job->codec, job->input, job->input_len, SIZE_MAX,
+                                 &job->consumed);
+    return NULL;
+}
+
+static void* width_job(void* arg) {
+    job_t* job = arg;
+    const char* text = (const char*)job->input;
+
+    if (job->codec == BASEX_CODEC_BASE91) {
+        int64_t bits = basex_base91_count_bits(text, job->input_len);
+        job->result = bits < 0 ? -1 : 0;
+        job->bits = bits < 0 ? 0 : (uint64_t)bits;
+    } else {
+        job->result = 0;
+        job->bits = (uint64_t)basex_base122_count_values(text, job->input_len) * 7;
+    }
+    return NULL;
+}
+
+static ssize_t stream_decode(job_t* job, const uint8_t* input, size_t input_len,
+                             uint8_t* output) {
+    return job->codec == BASEX_CODEC_BASE91
+        ? basex_base91_stream_decode(&job->stream, (const char*)input, input_len, output)
+        : basex_base122_stream_decode(&job->stream, (const char*)input, input_len, output);
+}
+
+static void* stream_job(void* arg) {
+    job_t* job = arg;
+    size_t head = job->input_len < HEAD_CHARS ? job->input_len : HEAD_CHARS;
+
+    ssize_t first = stream_decode(job, job->input, head, job->head);
+    if (first < 0) {
+        job->result = -1;
+        return NULL;
+    }
+    ssize_t rest = stream_decode(job, job->input + head, job->input_len - head,
+                                 job->output + first);
+    job->head_len = (size_t)first;
+    job->result = rest < 0 ? -1 : first + rest;
+    return NULL;
+}
+
+// Run jobs[1..count-1] on new threads and jobs[0] on the caller
+static void run_all(job_t* jobs, size_t count, void* (*fn)(void*)) {
+    pthread_t threads[MAX_THREADS];
+    bool started[MAX_THREADS];
+
+    for (size_t k = 1; k < count; k++) {
+        started[k] = pthread_create(&threads[k], NULL, fn, &jobs[k]) == 0;
+        if (!started[k]) fn(&jobs[k]); // Out of threads: run it here
+    }
+    fn(&jobs[0]);
+    for (size_t k = 1; k < count; k++) {
+        if (started[k]) pthread_join(threads[k], NULL);
+    }
+}
+
+// Number of pieces: the requested threads (0 = online CPUs), but no piece
+// smaller than MIN_PIECE
+static size_t piece_count(int threads, size_t input_len) {
+    long count = threads > 0 ? threads : sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) count = 1;
+    if (count > MAX_THREADS) count = MAX_THREADS;
+    if ((size_t)count > input_len / MIN_PIECE) count = (long)(input_len / MIN_PIECE);
+    return count > 1 ? (size_t)count : 1;
+}
+
+// Sum of the results, or -1 if a piece failed or a piece before the last
+// came up short of its full blocks (a decoder skipped characters)
+static ssize_t collect(const job_t* jobs, size_t count, size_t in_block, size_t out_block) {
+    size_t total = 0;
+
+    for (size_t k = 0; k < count; k++) {
+        if (jobs[k].result < 0) return -1;
+        if (k + 1 < count && (size_t)jobs[k].result != jobs[k].input_len / in_block * out_block) {
+            return -1;
+        }
+        total += (size_t)jobs[k].result;
+    }
+    return (ssize_t)total;
+}
+
+// Split on in_block boundaries and code the pieces in parallel
+static ssize_t code_blocks(job_t* jobs, size_t count, basex_codec_t codec, bool decode,
+                           size_t in_block, size_t out_block, const uint8_t* input,
+                           size_t input_len, uint8_t* output) {
+    size_t piece = (input_len / count + in_block - 1) / in_block * in_block;
+
+    for (size_t k = 0; k < count; k++) {
+        size_t start = k * piece < input_len ? k * piece : input_len;
+        size_t end = k + 1 < count && start + piece < input_len ? start + piece : input_len;
+        jobs[k] = (job_t){ .codec = codec, .decode = decode, .input = input + start,
+                           .input_len = end - start,
+                           .output = output + start / in_block * out_block };
+    }
+    run_all(jobs, count, code_job);
+    return collect(jobs, count, in_block, out_block);
+}
+
+static ssize_t code_parallel(basex_codec_t codec, bool decode, size_t in_block, size_t out_block,
+                             const void* input, size_t input_len, void* output, int threads) {
+    job_t jobs[MAX_THREADS];
+
+    if (!input || !output) return -1;
+
+    size_t count = piece_count(threads, input_len);
+    if (count == 1) {
+        jobs[0] = (job_t){ .codec = codec, .decode = decode, .input = input,
+                           .input_len = input_len, .output = output };
+        code_job(&jobs[0]);
+        return jobs[0].result;
+    }
+    return code_blocks(jobs, count, codec, decode, in_block, out_block, input, input_len,
+                       output);
+}
+
+// Base32/Base64 decoding skips non-alphabet characters and stops at '=',
+// so byte offsets only line up with groups for unbroken input. That is
+// tried first; otherwise alphabet characters are counted per piece and
+// each split moved forward to the next whole group.
+static ssize_t decode_lenient(basex_codec_t codec, size_t in_block, size_t out_block,
+                              const char* input, size_t input_len, uint8_t* output,
+                              int threads) {
+    job_t jobs[MAX_THREADS];
+    const uint8_t* in = (const uint8_t*)input;
+
+    if (!input || !output) return -1;
+
+    size_t count = piece_count(threads, input_len);
+    if (count == 1) {
+        return codec == BASEX_CODEC_BASE32 ? basex_base32_decode(input, input_len, output)
+                                           : basex_base64_decode(input, input_len, output);
+    }
+
+    // These decoders never fail, so -1 means a piece came up short
+    ssize_t result = code_blocks(jobs, count, codec, true, in_block, out_block, in, input_len,
+                                 output);
+    if (result >= 0) return result;
+
+    // Alphabet characters per piece, up to the first '='
+    size_t piece = input_len / count;
+    for (size_t k = 0; k < count; k++) {
+        size_t start = k * piece;
+        jobs[k] = (job_t){ .codec = codec, .input = in + start,
+                           .input_len = k + 1 < count ? piece : input_len - start };
+    }
+    run_all(jobs, count, count_job);
+
+    // Pieces past the first '=' decode to nothing
+    size_t used = 1;
+    while (used < count && jobs[used - 1].consumed == jobs[used - 1].input_len) used++;
+
+    size_t starts[MAX_THREADS];
+    size_t offsets[MAX_THREADS];
+    size_t before = 0;
+    starts[0] = 0;
+    offsets[0] = 0;
+    for (size_t k = 1; k < used; k++) {
+        before += jobs[k - 1].symbols;
+
+        // Walk to the next group boundary; stop splitting if the input
+        // ends (or pads) before it
+        size_t start = (size_t)(jobs[k].input - in);
+        size_t skip = (in_block - before % in_block) % in_block;
+        size_t consumed = 0;
+        size_t found = count_symbols(codec, in + start, input_len - start, skip, &consumed);
+        if (found < skip) {
+            used = k;
+            break;
+        }
+        starts[k] = start + consumed;
+        offsets[k] = (before + skip) / in_block * out_block;
+    }
+
+    for (size_t k = 0; k < used; k++) {
+        size_t end = k + 1 < used ? starts[k + 1] : input_len;
+        jobs[k] = (job_t){ .codec = codec, .decode = true, .input = in + starts[k],
+                           .input_len = end - starts[k], .output = output + offsets[k] };
+    }
+    run_all(jobs, used, code_job);
+
+    for (size_t k = 0; k < used; k++) {
+        if (jobs[k].result < 0) return -1;
+    }
+    return (ssize_t)offsets[used - 1] + jobs[used - 1].result;
+}
+
+// Base91 pairs (13 or 14 bits) and Base122 values (7 bits, or none for an
+// escape marker) have data-dependent widths, but each piece can count its
+// own. An exclusive scan of the counts gives every piece its output bit
+// offset; it decodes from there as if the bits before it in its first
+// byte were zero, and the byte shared with the previous piece is merged
+// afterwards. Leftover bits, an odd Base91 character and an open escape
+// stay in the stream, as with basex_stream_update().
+ssize_t basex_stream_decode_parallel(basex_stream_t* stream, const char* input, size_t input_len,
+                                     uint8_t* output, int threads) {
+    job_t jobs[MAX_THREADS];
+    basex_codec_t codec = stream->codec;
+    const uint8_t* in = (const uint8_t*)input;
+    size_t out_pos = 0;
+
+    size_t count = piece_count(threads, input_len);
+    if (count == 1) {
+        return codec == BASEX_CODEC_BASE91
+            ? basex_base91_stream_decode(stream, input, input_len, output)
+            : basex_base122_stream_decode(stream, input, input_len, output);
+    }
+
+    // Close an open pair or escape first, so the first piece starts clean
+    if (stream->pending >= 0 || stream->escaped) {
+        jobs[0] = (job_t){ .codec = codec, .stream = *stream };
+        ssize_t result = stream_decode(&jobs[0], in, 1, output);
+        if (result < 0) return -1;
+        *stream = jobs[0].stream;
+        out_pos = (size_t)result;
+        in++;
+        input_len--;
+    }
+
+    // Base91 splits between pairs, Base122 where no escape is open
+    size_t piece = input_len / count;
+    size_t starts[MAX_THREADS + 1];
+    starts[0] = 0;
+    starts[count] = input_len;
+    for (size_t k = 1; k < count; k++) {
+        size_t start = k * piece;
+        if (codec == BASEX_CODEC_BASE91) {
+            start &= ~(size_t)1;
+        } else {
+            while (start < input_len && in[start - 1] == 0xC2) start++;
+        }
+        starts[k] = start > starts[k - 1] ? start : starts[k - 1];
+    }
+
+    // Phase 1: output bits per piece
+    for (size_t k = 0; k < count; k++) {
+        jobs[k] = (job_t){ .codec = codec, .input = in + starts[k],
+                           .input_len = starts[k + 1] - starts[k] };
+    }
+    run_all(jobs, count, width_job);
+
+    // Phase 2: exclusive scan into bit offsets, after the bits the stream
+    // already holds
+    uint64_t offset = stream->bits;
+    for (size_t k = 0; k < count; k++) {
+        if (jobs[k].result < 0) return -1;
+        jobs[k].output = output + out_pos + offset / 8;
+        if (k == 0) {
+            jobs[k].stream = *stream;
+        } else {
+            basex_stream_init(&jobs[k].stream, codec, true);
+            jobs[k].stream.bits = (unsigned)(offset % 8);
+        }
+        offset += jobs[k].bits;
+    }
+
+    // Phase 3: decode every piece at its offset
+    run_all(jobs, count, stream_job);
+    for (size_t k = 0; k < count; k++) {
+        if (jobs[k].result < 0) return -1;
+        memcpy(jobs[k].output, jobs[k].head, jobs[k].head_len);
+    }
+
+    // Fill the zero bits at the start of each piece with the bits the
+    // pieces before it left over (Base91 is LSB first, Base122 MSB first)
+    bool lsb_first = codec == BASEX_CODEC_BASE91;
+    uint64_t carry = jobs[0].stream.accumulator;
+    unsigned carry_bits = jobs[0].stream.bits;
+    for (size_t k = 1; k < count; k++) {
+        const basex_stream_t* piece_stream = &jobs[k].stream;
+
+        if (jobs[k].result > 0) {
+            jobs[k].output[0] |= (uint8_t)(lsb_first ? carry : carry << (8 - carry_bits));
+            carry = piece_stream->accumulator;
+        } else {
+            carry = lsb_first
+                ? carry | piece_stream->accumulator
+                : carry << (piece_stream->bits - carry_bits) | piece_stream->accumulator;
+        }
+        carry_bits = piece_stream->bits;
+    }
+
+    stream->accumulator = carry;
+    stream->bits = carry_bits;
+    stream->pending = jobs[count - 1].stream.pending;
+    stream->escaped = jobs[count - 1].stream.escaped;
+    return (ssize_t)(out_pos + offset / 8);
+}
+
+ssize_t basex_base32_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads) {
+    return code_parallel(BASEX_CODEC_BASE32, false, 5, 8, input, input_len, output, threads);
+}
+
+ssize_t basex_base32_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads) {
+    return decode_lenient(BASEX_CODEC_BASE32, 8, 5, input, input_len, output, threads);
+}
+
+ssize_t basex_base64_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads) {
+    return code_parallel(BASEX_CODEC_BASE64, false, 3, 4, input, input_len, output, threads);
+}
+
+ssize_t basex_base64_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads) {
+    return decode_lenient(BASEX_CODEC_BASE64, 4, 3, input, input_len, output, threads);
+}
+
+ssize_t basex_base85_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                     int threads) {
+    return code_parallel(BASEX_CODEC_BASE85, false, 4, 5, input, input_len, output, threads);
+}
+
+ssize_t basex_base85_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads) {
+    return code_parallel(BASEX_CODEC_BASE85, true, 5, 4, input, input_len, output, threads);
+}
+
+ssize_t basex_base122_encode_parallel(const uint8_t* input, size_t input_len, char* output,
+                                      int threads) {
+    // Whole 7-byte blocks are 8 characters: 0x80 | group never needs escaping
+    return code_parallel(BASEX_CODEC_BASE122, false, 7, 8, input, input_len, output, threads);
+}
+
+ssize_t basex_base91_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                     int threads) {
+    basex_stream_t stream;
+
+    if (!input || !output) return -1;
+
+    basex_stream_init(&stream, BASEX_CODEC_BASE91, true);
+    ssize_t out_pos = basex_stream_decode_parallel(&stream, input, input_len, output, threads);
+    if (out_pos < 0) return -1;
+    return out_pos + (ssize_t)basex_base91_stream_decode_final(&stream, output + out_pos);
+}
+
+ssize_t basex_base122_decode_parallel(const char* input, size_t input_len, uint8_t* output,
+                                      int threads) {
+    basex_stream_t stream;
+
+    if (!input || !output) return -1;
+
+    basex_stream_init(&stream, BASEX_CODEC_BASE122, true);
+    return basex_stream_decode_parallel(&stream, input, input_len, output, threads);
+}
@@ -0,0 +1,30 @@
+// Parallel coding helpers
+// Base32/Base64 decoding skips non-alphabet characters (line breaks), so
+// parallel.c counts alphabet characters to find group boundaries. Base91
+// pairs and Base122 values have data-dependent widths, so it counts the
+// bits of each piece to find its output offset.
+
+#ifndef BASEX_PARALLEL_H
+#define BASEX_PARALLEL_H
+
+#include "../../include/basex.h"
+
+// Count alphabet characters up to the first '=', stopping once limit are
+// found; *consumed is set to the position reached
+size_t basex_base32_count_symbols(const char* input, size_t input_len, size_t limit,
+                                  size_t* consumed);
+size_t basex_base64_count_symbols(const char* input, size_t input_len, size_t limit,
+                                  size_t* consumed);
+
+// Bits carried by the whole pairs of a Base91 string, -1 on an invalid
+// character
+int64_t basex_base91_count_bits(const char* input, size_t input_len);
+
+// Number of 7-bit values in a Base122 string that does not start escaped
+size_t basex_base122_count_values(const char* input, size_t input_len);
+
+// Base91/Base122 stream decoding split across threads
+ssize_t basex_stream_decode_parallel(basex_stream_t* stream, const char* input, size_t input_len,
+                                     uint8_t* output, int threads);
+
+#endif /* BASEX_PARALLEL_H */
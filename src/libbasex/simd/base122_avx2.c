@@ -1,13 +1,189 @@
-// AVX2-optimized Base122 encoding
-// Placeholder for future SIMD implementation
+// AVX2-optimized Base122 encoding/decoding
+// Encoding splits four 7-byte blocks (28 bytes -> 32 characters) per
+// iteration into 7-bit groups with a pshufb + per-word multiply-shift.
+// Decoding removes 0xC2 escape markers with a compaction table and packs
+// 32 7-bit values back into 28 bytes with shifts/madd/pshufb.
+//
+// Output bytes are always 0x80 | group while every BASE122_ILLEGAL byte is
+// ASCII, so no encoded byte ever needs the 0xC2 escape.
 
-#include "../../../include/basex.h"
+#include "simd.h"
 
 #ifdef HAVE_AVX2
 
-// TODO: Implement AVX2-optimized Base122 encoding
-// - Vectorized 7-bit extraction
-// - Parallel illegal byte detection
-// - Expected speedup: 4-6x over portable version
+#include "base122_compact.h"
+#include <immintrin.h>
+#include <string.h>
+
+// Expand two 7-byte blocks (one per 128-bit lane) into 16 7-bit groups,
+// one per 16-bit word: each word holds the two big-endian source bytes
+// spanning the group and a per-word mulhi performs the variable shift.
+static inline __m256i enc_expand(__m256i in) {
+    const __m256i shuf = _mm256_setr_epi8(
+        1, 0, 1, 0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, -1, 6,
+        8, 7, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 12, -1, 13);
+    // x >> s == mulhi(x, 1 << (16 - s)); shifts are 9,2,3,4,5,6,7,8
+    const __m256i mul = _mm256_setr_epi16(
+        1 << 7, 1 << 14, 1 << 13, 1 << 12, 1 << 11, 1 << 10, 1 << 9, 1 << 8,
+        1 << 7, 1 << 14, 1 << 13, 1 << 12, 1 << 11, 1 << 10, 1 << 9, 1 << 8);
+
+    __m256i words = _mm256_shuffle_epi8(in, shuf);
+    words = _mm256_mulhi_epu16(words, mul);
+    return _mm256_and_si256(words, _mm256_set1_epi16(0x7F));
+}
+
+size_t basex_base122_encode_avx2(const uint8_t* input, size_t input_len, char* output) {
+    size_t i = 0;
+
+    // Each iteration reads 30 bytes (two 16-byte loads at +0 and +14)
+    for (; i + 30 <= input_len; i += 28) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(input + i + 14));
+
+        __m256i a = enc_expand(_mm256_broadcastsi128_si256(lo));
+        __m256i b = enc_expand(_mm256_broadcastsi128_si256(hi));
+
+        // packus interleaves lanes as [b0 b2 | b1 b3]; restore block order
+        __m256i groups = _mm256_packus_epi16(a, b);
+        groups = _mm256_permute4x64_epi64(groups, _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m256i bytes = _mm256_or_si256(groups, _mm256_set1_epi8((char)0x80));
+        _mm256_storeu_si256((__m256i*)(output + (i / 7) * 8), bytes);
+    }
+
+    return i;
+}
+
+// Staging area for compacted 7-bit values between unpacking and packing
+#define STAGE_SIZE 512
+
+// Pack 32 7-bit values into 28 bytes (8 values -> 56 bits per 64-bit lane)
+static inline void dec_pack(__m256i values, uint8_t* output) {
+    const __m256i pack_shuf = _mm256_setr_epi8(
+        6, 5, 4, 3, 2, 1, 0, 14, 13, 12, 11, 10, 9, 8, -1, -1,
+        6, 5, 4, 3, 2, 1, 0, 14, 13, 12, 11, 10, 9, 8, -1, -1);
+
+    // v0 << 7 | v1, then w0 << 14 | w1, then d0 << 28 | d1
+    __m256i merged = _mm256_or_si256(
+        _mm256_and_si256(_mm256_slli_epi16(values, 7), _mm256_set1_epi16(0x3F80)),
+        _mm256_srli_epi16(values, 8));
+    merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00014000));
+    merged = _mm256_or_si256(_mm256_srli_epi64(merged, 32), _mm256_slli_epi64(merged, 28));
+    merged = _mm256_shuffle_epi8(merged, pack_shuf);
+
+    // The second store overwrites the 2 unused bytes of the first
+    _mm_storeu_si128((__m128i*)output, _mm256_castsi256_si128(merged));
+    _mm_storeu_si128((__m128i*)(output + 14), _mm256_extracti128_si256(merged, 1));
+}
+
+// Escape markers in a block: a 0xC2 is a marker unless the byte before it
+// was one. Within each run of 0xC2 bytes markers therefore sit at even
+// offsets from the run start. Runs are split by start parity using the
+// carry of an add (as in simdjson's odd-backslash detection).
+static inline uint32_t find_markers(uint32_t c2, uint32_t escaped) {
+    const uint64_t even = 0x55555555u;
+    uint64_t m = c2 & ~escaped; // An escaped first byte is data
+    uint64_t starts = m & ~(m << 1);
+    uint64_t even_starts = starts & even;
+    // Adding a run's start bit clears the whole run, so only the bits of
+    // odd-start runs survive the AND
+    uint64_t odd_runs = m & (m + even_starts);
+    uint64_t even_runs = m & ~odd_runs;
+    return (uint32_t)((even_runs & even) | (odd_runs & ~even));
+}
+
+size_t basex_base122_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    uint8_t stage[STAGE_SIZE + 64];
+    size_t staged = 0;
+    size_t out_pos = 0;
+    size_t i = 0;
+    uint32_t escaped = 0;
+    uint32_t last_kept = 0;
+    uint32_t last_markers = 0;
+    uint32_t last_escaped = 0;
+
+    for (; i + 32 <= input_len; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(input + i));
+        uint32_t c2 = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8((char)0xC2)));
+        uint32_t markers = find_markers(c2, escaped);
+        uint32_t kept = ~markers;
+        __m256i values = _mm256_and_si256(block, _mm256_set1_epi8(0x7F));
+
+        if (markers == 0) {
+            _mm256_storeu_si256((__m256i*)(stage + staged), values);
+            staged += 32;
+        } else {
+            uint8_t chunk[32];
+            _mm256_storeu_si256((__m256i*)chunk, values);
+            for (int c = 0; c < 4; c++) {
+                uint32_t mask = (kept >> (8 * c)) & 0xFF;
+                __m128i bytes = _mm_loadl_epi64((const __m128i*)(chunk + 8 * c));
+                __m128i shuf = _mm_cvtsi64_si128((long long)BASE122_COMPACT_TABLE[mask]);
+                _mm_storel_epi64((__m128i*)(stage + staged), _mm_shuffle_epi8(bytes, shuf));
+                staged += (size_t)__builtin_popcount(mask);
+            }
+        }
+
+        last_kept = kept;
+        last_markers = markers;
+        last_escaped = escaped;
+        escaped = markers >> 31;
+
+        if (staged >= STAGE_SIZE) {
+            size_t packed = staged & ~(size_t)31;
+            for (size_t k = 0; k < packed; k += 32) {
+                dec_pack(_mm256_loadu_si256((const __m256i*)(stage + k)), output + out_pos);
+                out_pos += 28;
+            }
+            memmove(stage, stage + packed, staged - packed);
+            staged -= packed;
+        }
+    }
+
+    if (i == 0) {
+        *output_len = 0;
+        return 0;
+    }
+
+    // Flush whole 8-value groups; the rest (< 8 values) is handed back
+    size_t k = 0;
+    for (; k + 32 <= staged; k += 32) {
+        dec_pack(_mm256_loadu_si256((const __m256i*)(stage + k)), output + out_pos);
+        out_pos += 28;
+    }
+    for (; k + 8 <= staged; k += 8) {
+        uint64_t value = 0;
+        for (int j = 0; j < 8; j++) {
+            value = (value << 7) | stage[k + j];
+        }
+        for (int j = 6; j >= 0; j--) {
+            output[out_pos++] = (uint8_t)(value >> (8 * j));
+        }
+    }
+
+    // Every block keeps at least 16 values, so the leftovers all come from
+    // the last block. Rewind to the first of them (or to the marker that
+    // escapes it) so the scalar loop resumes with no pending state.
+    size_t leftover = staged - k;
+    size_t consumed = i;
+    if (leftover > 0) {
+        uint32_t kept = last_kept;
+        int pos = 0;
+        for (size_t j = 0; j < leftover; j++) {
+            pos = 31 - __builtin_clz(kept);
+            kept &= ~(1u << pos);
+        }
+        consumed = i - 32 + (size_t)pos;
+        bool after_marker = pos > 0 ? (last_markers >> (pos - 1)) & 1 : last_escaped;
+        if (after_marker) consumed--;
+    } else if (escaped) {
+        consumed--; // Re-read the trailing marker
+    }
+
+    *output_len = out_pos;
+    return consumed;
+}
 
 #endif
@@ -0,0 +1,98 @@
+// BMI2 Base122 encoding/decoding
+// Scalar fast path: PDEP spreads a 56-bit block into eight 7-bit byte
+// lanes and PEXT gathers eight characters back into 56 bits. Used as the
+// tier below SSE4.1 and for the tails the vector kernels leave.
+
+#include "simd.h"
+
+#ifdef HAVE_BMI
+
+#include <immintrin.h>
+#include <string.h>
+
+#define LOW7 0x7F7F7F7F7F7F7F7FULL
+
+size_t basex_base122_encode_bmi2(const uint8_t* input, size_t input_len, char* output) {
+    size_t i = 0;
+
+    // Each iteration reads 8 bytes and consumes 7
+    for (; i + 8 <= input_len; i += 7) {
+        uint64_t word;
+        memcpy(&word, input + i, sizeof(word));
+
+        // Big-endian 56-bit block -> one group per byte, first group in byte 0
+        uint64_t groups = _pdep_u64(__builtin_bswap64(word) >> 8, LOW7);
+        groups = __builtin_bswap64(groups) | 0x8080808080808080ULL;
+
+        memcpy(output + (i / 7) * 8, &groups, sizeof(groups));
+    }
+
+    return i;
+}
+
+// Write 56 bits as 7 big-endian bytes (the 8-byte store's last byte is
+// overwritten by the next one)
+static inline void store56(uint8_t* output, uint64_t bits) {
+    uint64_t bytes = __builtin_bswap64(bits << 8);
+    memcpy(output, &bytes, sizeof(bytes));
+}
+
+size_t basex_base122_decode_bmi2(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    uint64_t pending = 0; // 7-bit values not yet written, oldest on top
+    unsigned count = 0;   // Number of pending values (< 8)
+    bool escaped = false;
+    size_t i = 0;
+    size_t out_pos = 0;
+    // Last position with nothing pending; the scalar loop resumes there
+    size_t safe_in = 0;
+    size_t safe_out = 0;
+
+    for (; i + 8 <= input_len; i += 8) {
+        uint64_t word;
+        memcpy(&word, input + i, sizeof(word));
+
+        // Any 0xC2 byte? (zero-byte test on word ^ 0xC2..C2)
+        uint64_t x = word ^ 0xC2C2C2C2C2C2C2C2ULL;
+        bool has_marker = ((x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL) != 0;
+
+        if (!has_marker && !escaped) {
+            // Eight values -> 56 bits, first character on top
+            uint64_t values = _pext_u64(__builtin_bswap64(word), LOW7);
+            unsigned shift = 7 * count;
+            store56(output + out_pos, (pending << (56 - shift)) | (values >> shift));
+            out_pos += 7;
+            pending = values & ((1ULL << shift) - 1);
+
+            // Nothing was pending right after the (8 - count)th character
+            safe_in = i + 8 - count;
+            safe_out = out_pos;
+            continue;
+        }
+
+        for (int k = 0; k < 8; k++) {
+            uint8_t byte = (uint8_t)input[i + k];
+            if (byte == 0xC2 && !escaped) {
+                escaped = true;
+                continue;
+            }
+            escaped = false;
+            pending = (pending << 7) | (byte & 0x7F);
+            if (++count == 8) {
+                store56(output + out_pos, pending);
+                out_pos += 7;
+                pending = 0;
+                count = 0;
+            }
+            if (count == 0) {
+                safe_in = i + k + 1;
+                safe_out = out_pos;
+            }
+        }
+    }
+
+    *output_len = safe_out;
+    return safe_in;
+}
+
+#endif
@@ -0,0 +1,164 @@
+// SSSE3/SSE4.1 Base122 encoding/decoding
+// 128-bit version of the AVX2 kernels: two 7-byte blocks (14 bytes -> 16
+// characters) per encode iteration, 16 characters per decode iteration.
+
+#include "simd.h"
+
+#ifdef HAVE_SSE41
+
+#include "base122_compact.h"
+#include <smmintrin.h>
+#include <string.h>
+
+// Expand one 7-byte block into 8 7-bit groups, one per 16-bit word
+// (see base122_avx2.c)
+static inline __m128i enc_expand(__m128i in, __m128i shuf) {
+    // x >> s == mulhi(x, 1 << (16 - s)); shifts are 9,2,3,4,5,6,7,8
+    const __m128i mul = _mm_setr_epi16(
+        1 << 7, 1 << 14, 1 << 13, 1 << 12, 1 << 11, 1 << 10, 1 << 9, 1 << 8);
+
+    __m128i words = _mm_shuffle_epi8(in, shuf);
+    words = _mm_mulhi_epu16(words, mul);
+    return _mm_and_si128(words, _mm_set1_epi16(0x7F));
+}
+
+size_t basex_base122_encode_sse41(const uint8_t* input, size_t input_len, char* output) {
+    const __m128i shuf_a = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, -1, 6);
+    const __m128i shuf_b = _mm_setr_epi8(8, 7, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 12, -1, 13);
+    size_t i = 0;
+
+    // Each iteration reads 16 bytes and consumes 14
+    for (; i + 16 <= input_len; i += 14) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i groups = _mm_packus_epi16(enc_expand(in, shuf_a), enc_expand(in, shuf_b));
+
+        __m128i bytes = _mm_or_si128(groups, _mm_set1_epi8((char)0x80));
+        _mm_storeu_si128((__m128i*)(output + (i / 7) * 8), bytes);
+    }
+
+    return i;
+}
+
+// Staging area for compacted 7-bit values between unpacking and packing
+#define STAGE_SIZE 512
+
+// Pack 16 7-bit values into 14 bytes (8 values -> 56 bits per 64-bit lane)
+static inline void dec_pack(__m128i values, uint8_t* output) {
+    const __m128i pack_shuf = _mm_setr_epi8(6, 5, 4, 3, 2, 1, 0, 14, 13, 12, 11, 10, 9, 8, -1, -1);
+
+    // v0 << 7 | v1, then w0 << 14 | w1, then d0 << 28 | d1
+    __m128i merged = _mm_or_si128(
+        _mm_and_si128(_mm_slli_epi16(values, 7), _mm_set1_epi16(0x3F80)),
+        _mm_srli_epi16(values, 8));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00014000));
+    merged = _mm_or_si128(_mm_srli_epi64(merged, 32), _mm_slli_epi64(merged, 28));
+    merged = _mm_shuffle_epi8(merged, pack_shuf);
+
+    // Two overlapping 8-byte stores write exactly 14 bytes
+    _mm_storel_epi64((__m128i*)output, merged);
+    _mm_storel_epi64((__m128i*)(output + 6), _mm_srli_si128(merged, 6));
+}
+
+// Escape markers in a 16-byte block (see find_markers in base122_avx2.c)
+static inline uint32_t find_markers(uint32_t c2, uint32_t escaped) {
+    const uint32_t even = 0x5555u;
+    uint32_t m = c2 & ~escaped; // An escaped first byte is data
+    uint32_t starts = m & ~(m << 1);
+    uint32_t even_starts = starts & even;
+    uint32_t odd_runs = m & (m + even_starts);
+    uint32_t even_runs = m & ~odd_runs;
+    return ((even_runs & even) | (odd_runs & ~even)) & 0xFFFF;
+}
+
+size_t basex_base122_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                  size_t* output_len) {
+    uint8_t stage[STAGE_SIZE + 32];
+    size_t staged = 0;
+    size_t out_pos = 0;
+    size_t i = 0;
+    uint32_t escaped = 0;
+    uint32_t last_kept = 0;
+    uint32_t last_markers = 0;
+    uint32_t last_escaped = 0;
+
+    for (; i + 16 <= input_len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(input + i));
+        uint32_t c2 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8((char)0xC2)));
+        uint32_t markers = find_markers(c2, escaped);
+        uint32_t kept = ~markers & 0xFFFF;
+        __m128i values = _mm_and_si128(block, _mm_set1_epi8(0x7F));
+
+        if (markers == 0) {
+            _mm_storeu_si128((__m128i*)(stage + staged), values);
+            staged += 16;
+        } else {
+            __m128i shuf_lo = _mm_cvtsi64_si128((long long)BASE122_COMPACT_TABLE[kept & 0xFF]);
+            __m128i shuf_hi = _mm_cvtsi64_si128((long long)BASE122_COMPACT_TABLE[kept >> 8]);
+            _mm_storel_epi64((__m128i*)(stage + staged), _mm_shuffle_epi8(values, shuf_lo));
+            staged += (size_t)__builtin_popcount(kept & 0xFF);
+            _mm_storel_epi64((__m128i*)(stage + staged),
+                             _mm_shuffle_epi8(_mm_srli_si128(values, 8), shuf_hi));
+            staged += (size_t)__builtin_popcount(kept >> 8);
+        }
+
+        last_kept = kept;
+        last_markers = markers;
+        last_escaped = escaped;
+        escaped = markers >> 15;
+
+        if (staged >= STAGE_SIZE) {
+            size_t packed = staged & ~(size_t)15;
+            for (size_t k = 0; k < packed; k += 16) {
+                dec_pack(_mm_loadu_si128((const __m128i*)(stage + k)), output + out_pos);
+                out_pos += 14;
+            }
+            memmove(stage, stage + packed, staged - packed);
+            staged -= packed;
+        }
+    }
+
+    if (i == 0) {
+        *output_len = 0;
+        return 0;
+    }
+
+    // Flush whole 8-value groups; the rest (< 8 values) is handed back
+    size_t k = 0;
+    for (; k + 16 <= staged; k += 16) {
+        dec_pack(_mm_loadu_si128((const __m128i*)(stage + k)), output + out_pos);
+        out_pos += 14;
+    }
+    for (; k + 8 <= staged; k += 8) {
+        uint64_t value = 0;
+        for (int j = 0; j < 8; j++) {
+            value = (value << 7) | stage[k + j];
+        }
+        for (int j = 6; j >= 0; j--) {
+            output[out_pos++] = (uint8_t)(value >> (8 * j));
+        }
+    }
+
+    // Every block keeps at least 8 values, so the leftovers all come from
+    // the last block. Rewind to the first of them (or to the marker that
+    // escapes it) so the scalar loop resumes with no pending state.
+    size_t leftover = staged - k;
+    size_t consumed = i;
+    if (leftover > 0) {
+        uint32_t kept = last_kept;
+        int pos = 0;
+        for (size_t j = 0; j < leftover; j++) {
+            pos = 31 - __builtin_clz(kept);
+            kept &= ~(1u << pos);
+        }
+        consumed = i - 16 + (size_t)pos;
+        bool after_marker = pos > 0 ? (last_markers >> (pos - 1)) & 1 : last_escaped;
+        if (after_marker) consumed--;
+    } else if (escaped) {
+        consumed--; // Re-read the trailing marker
+    }
+
+    *output_len = out_pos;
+    return consumed;
+}
+
+#endif
@@ -0,0 +1,104 @@
+// AVX2-optimized Base32 encoding/decoding (RFC 4648)
+// Encodes 20 bytes -> 32 characters and decodes 32 characters -> 20 bytes
+// per iteration
+
+#include "simd.h"
+
+#ifdef HAVE_AVX2
+
+#include <immintrin.h>
+#include <string.h>
+
+// Expand two 5-byte groups (one per 128-bit lane) into 16 5-bit indices,
+// one per 16-bit word. Each word holds the two source bytes spanning the
+// field (big-endian), and a per-word mulhi performs the variable shift.
+static inline __m256i enc_expand(__m256i in) {
+    const __m256i shuf = _mm256_setr_epi8(
+        1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, -1, 4,
+        6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, -1, 9);
+    // x >> s == mulhi(x, 1 << (16 - s)); shifts are 11,6,9,4,7,10,5,8
+    const __m256i mul = _mm256_setr_epi16(
+        1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8,
+        1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8);
+
+    __m256i words = _mm256_shuffle_epi8(in, shuf);
+    words = _mm256_mulhi_epu16(words, mul);
+    return _mm256_and_si256(words, _mm256_set1_epi16(0x1F));
+}
+
+size_t basex_base32_encode_avx2(const uint8_t* input, size_t input_len, char* output) {
+    size_t i = 0;
+
+    // Each iteration reads 26 bytes (two 16-byte loads at +0 and +10)
+    for (; i + 26 <= input_len; i += 20) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(input + i + 10));
+
+        __m256i a = enc_expand(_mm256_broadcastsi128_si256(lo));
+        __m256i b = enc_expand(_mm256_broadcastsi128_si256(hi));
+
+        // packus interleaves lanes as [g0 g2 | g1 g3]; restore group order
+        __m256i indices = _mm256_packus_epi16(a, b);
+        indices = _mm256_permute4x64_epi64(indices, _MM_SHUFFLE(3, 1, 2, 0));
+
+        // 0-25 -> 'A'..'Z', 26-31 -> '2'..'7'
+        __m256i digits = _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25));
+        __m256i ascii = _mm256_add_epi8(indices, _mm256_set1_epi8('A'));
+        ascii = _mm256_add_epi8(ascii, _mm256_and_si256(digits, _mm256_set1_epi8('2' - 26 - 'A')));
+
+        _mm256_storeu_si256((__m256i*)(output + (i / 5) * 8), ascii);
+    }
+
+    return i;
+}
+
+static inline __m256i in_range(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+}
+
+size_t basex_base32_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len) {
+    const __m256i pack_shuf = _mm256_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1,
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 32 <= input_len; i += 32) {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(input + i));
+
+        // Fold case like BASE32_DECODE_TABLE: 'a'-'z' decode as 'A'-'Z'.
+        // Signed compares also reject every byte >= 0x80.
+        __m256i lower = _mm256_or_si256(str, _mm256_set1_epi8(0x20));
+        __m256i alpha = in_range(lower, 'a', 'z');
+        __m256i digit = in_range(str, '2', '7');
+        if (_mm256_movemask_epi8(_mm256_or_si256(alpha, digit)) != -1) {
+            break; // Padding or invalid character - let the scalar path handle it
+        }
+
+        __m256i values = _mm256_blendv_epi8(
+            _mm256_sub_epi8(str, _mm256_set1_epi8('2' - 26)),
+            _mm256_sub_epi8(lower, _mm256_set1_epi8('a')),
+            alpha);
+
+        // 8x5 bits -> 4x10 -> 2x20 -> 40 bits per 64-bit lane
+        __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0120));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00010400));
+        merged = _mm256_or_si256(_mm256_srli_epi64(merged, 32), _mm256_slli_epi64(merged, 20));
+        merged = _mm256_shuffle_epi8(merged, pack_shuf);
+
+        // Store exactly 20 bytes so we never write past decode_len()
+        __m128i hi = _mm256_extracti128_si256(merged, 1);
+        uint16_t tail = (uint16_t)_mm_extract_epi16(hi, 4);
+        _mm_storeu_si128((__m128i*)(output + out_pos), _mm256_castsi256_si128(merged));
+        _mm_storel_epi64((__m128i*)(output + out_pos + 10), hi);
+        memcpy(output + out_pos + 18, &tail, sizeof(tail));
+        out_pos += 20;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// AVX-512 VBMI Base32 encoding/decoding (RFC 4648)
+// One 5-byte group per 64-bit lane: vpmultishiftqb extracts the eight
+// 5-bit fields and vpermb translates them, 40 bytes <-> 64 characters
+// per iteration
+
+#include "simd.h"
+
+#ifdef HAVE_AVX512VBMI
+
+#include <immintrin.h>
+
+// Twice over, so vpermb's 6-bit index needs no masking to 5 bits
+static const char ALPHABET[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+// ASCII 0-127 -> index (either case); negative outside the alphabet
+static const int8_t DECODE_TABLE[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, 26, 27, 28, 29, 30, 31, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1
+};
+
+// Group j's bytes reversed into lane j: a 40-bit big-endian value
+static const uint8_t EXPAND[64] = {
+     4,  3,  2,  1,  0,  0,  0,  0,  9,  8,  7,  6,  5,  0,  0,  0,
+    14, 13, 12, 11, 10,  0,  0,  0, 19, 18, 17, 16, 15,  0,  0,  0,
+    24, 23, 22, 21, 20,  0,  0,  0, 29, 28, 27, 26, 25,  0,  0,  0,
+    34, 33, 32, 31, 30,  0,  0,  0, 39, 38, 37, 36, 35,  0,  0,  0
+};
+
+// Inverse of EXPAND: the low five bytes of each lane, most significant first
+static const uint8_t PACK[64] = {
+     4,  3,  2,  1,  0, 12, 11, 10,  9,  8, 20, 19, 18, 17, 16, 28,
+    27, 26, 25, 24, 36, 35, 34, 33, 32, 44, 43, 42, 41, 40, 52, 51,
+    50, 49, 48, 60, 59, 58, 57, 56,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+// 40 bytes in / out of a 64-byte register
+#define BLOCK_MASK 0x000000FFFFFFFFFFULL
+
+size_t basex_base32_encode_avx512(const uint8_t* input, size_t input_len, char* output) {
+    const __m512i expand = _mm512_loadu_si512((const void*)EXPAND);
+    // Bit offsets of the eight fields: 35, 30, 25, 20, 15, 10, 5, 0
+    const __m512i shifts = _mm512_set1_epi64(0x00050A0F14191E23);
+    const __m512i lut = _mm512_loadu_si512((const void*)ALPHABET);
+    size_t i = 0;
+
+    for (; i + 40 <= input_len; i += 40) {
+        __m512i in = _mm512_maskz_loadu_epi8(BLOCK_MASK, input + i);
+        in = _mm512_permutexvar_epi8(expand, in);
+        __m512i indices = _mm512_multishift_epi64_epi8(shifts, in);
+        _mm512_storeu_si512((void*)(output + (i / 5) * 8), _mm512_permutexvar_epi8(indices, lut));
+    }
+
+    return i;
+}
+
+size_t basex_base32_decode_avx512(const char* input, size_t input_len, uint8_t* output,
+                                  size_t* output_len) {
+    const __m512i lut_lo = _mm512_loadu_si512((const void*)DECODE_TABLE);
+    const __m512i lut_hi = _mm512_loadu_si512((const void*)(DECODE_TABLE + 64));
+    const __m512i pack = _mm512_loadu_si512((const void*)PACK);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 64 <= input_len; i += 64) {
+        __m512i str = _mm512_loadu_si512((const void*)(input + i));
+
+        // Table lookup on the low 7 bits; bytes >= 0x80 are invalid anyway
+        __m512i values = _mm512_permutex2var_epi8(lut_lo, str, lut_hi);
+        if (_mm512_movepi8_mask(_mm512_or_si512(values, str))) {
+            break; // Let the scalar path handle it (incl. '=')
+        }
+
+        // 5+5 -> 10 bits per word, 10+10 -> 20 bits per dword, 20+20 -> 40
+        __m512i merged = _mm512_maddubs_epi16(values, _mm512_set1_epi16(0x0120));
+        merged = _mm512_madd_epi16(merged, _mm512_set1_epi32(0x00010400));
+        merged = _mm512_or_si512(_mm512_srli_epi64(_mm512_slli_epi64(merged, 32), 12),
+                                 _mm512_srli_epi64(merged, 32));
+        merged = _mm512_permutexvar_epi8(pack, merged);
+
+        _mm512_mask_storeu_epi8(output + out_pos, BLOCK_MASK, merged);
+        out_pos += 40;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
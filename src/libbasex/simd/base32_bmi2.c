@@ -0,0 +1,35 @@
+// BMI2 Base32 encoding
+// Scalar fast path: PDEP spreads a 40-bit group into eight 5-bit byte
+// lanes, and the alphabet mapping is done SWAR-style on all eight at once.
+// Used as the tier below SSE4.1 and for the tails the vector kernels leave.
+
+#include "simd.h"
+
+#ifdef HAVE_BMI
+
+#include <immintrin.h>
+#include <string.h>
+
+size_t basex_base32_encode_bmi2(const uint8_t* input, size_t input_len, char* output) {
+    size_t i = 0;
+
+    // Each iteration reads 8 bytes and consumes 5
+    for (; i + 8 <= input_len; i += 5) {
+        uint64_t word;
+        memcpy(&word, input + i, sizeof(word));
+
+        // Big-endian 40-bit group -> one field per byte, first field in byte 0
+        uint64_t fields = _pdep_u64(__builtin_bswap64(word) >> 24, 0x1F1F1F1F1F1F1F1FULL);
+        fields = __builtin_bswap64(fields);
+
+        // 0-25 -> 'A'..'Z', 26-31 -> '2'..'7'; no lane carries into the next
+        uint64_t digits = ((fields + 0x6666666666666666ULL) & 0x8080808080808080ULL) >> 7;
+        uint64_t ascii = fields + 0x4141414141414141ULL - digits * ('A' + 26 - '2');
+
+        memcpy(output + (i / 5) * 8, &ascii, sizeof(ascii));
+    }
+
+    return i;
+}
+
+#endif
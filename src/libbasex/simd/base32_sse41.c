@@ -0,0 +1,90 @@
+// SSSE3/SSE4.1 Base32 encoding/decoding (RFC 4648)
+// 128-bit version of the AVX2 kernels: 10 bytes <-> 16 characters per
+// iteration
+
+#include "simd.h"
+
+#ifdef HAVE_SSE41
+
+#include <smmintrin.h>
+#include <string.h>
+
+// Expand one 5-byte group into 8 5-bit indices, one per 16-bit word
+// (see base32_avx2.c)
+static inline __m128i enc_expand(__m128i in, __m128i shuf) {
+    // x >> s == mulhi(x, 1 << (16 - s)); shifts are 11,6,9,4,7,10,5,8
+    const __m128i mul = _mm_setr_epi16(
+        1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8);
+
+    __m128i words = _mm_shuffle_epi8(in, shuf);
+    words = _mm_mulhi_epu16(words, mul);
+    return _mm_and_si128(words, _mm_set1_epi16(0x1F));
+}
+
+size_t basex_base32_encode_sse41(const uint8_t* input, size_t input_len, char* output) {
+    const __m128i shuf_a = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, -1, 4);
+    const __m128i shuf_b = _mm_setr_epi8(6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, -1, 9);
+    size_t i = 0;
+
+    // Each iteration reads 16 bytes and consumes 10
+    for (; i + 16 <= input_len; i += 10) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i indices = _mm_packus_epi16(enc_expand(in, shuf_a), enc_expand(in, shuf_b));
+
+        // 0-25 -> 'A'..'Z', 26-31 -> '2'..'7'
+        __m128i digits = _mm_cmpgt_epi8(indices, _mm_set1_epi8(25));
+        __m128i ascii = _mm_add_epi8(indices, _mm_set1_epi8('A'));
+        ascii = _mm_add_epi8(ascii, _mm_and_si128(digits, _mm_set1_epi8('2' - 26 - 'A')));
+
+        _mm_storeu_si128((__m128i*)(output + (i / 5) * 8), ascii);
+    }
+
+    return i;
+}
+
+static inline __m128i in_range(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), v));
+}
+
+size_t basex_base32_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    const __m128i pack_shuf = _mm_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 16 <= input_len; i += 16) {
+        __m128i str = _mm_loadu_si128((const __m128i*)(input + i));
+
+        // Fold case like BASE32_DECODE_TABLE; signed compares reject >= 0x80
+        __m128i lower = _mm_or_si128(str, _mm_set1_epi8(0x20));
+        __m128i alpha = in_range(lower, 'a', 'z');
+        __m128i digit = in_range(str, '2', '7');
+        if (_mm_movemask_epi8(_mm_or_si128(alpha, digit)) != 0xFFFF) {
+            break; // Padding or invalid character - let the scalar path handle it
+        }
+
+        __m128i values = _mm_blendv_epi8(
+            _mm_sub_epi8(str, _mm_set1_epi8('2' - 26)),
+            _mm_sub_epi8(lower, _mm_set1_epi8('a')),
+            alpha);
+
+        // 8x5 bits -> 4x10 -> 2x20 -> 40 bits per 64-bit lane
+        __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0120));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00010400));
+        merged = _mm_or_si128(_mm_srli_epi64(merged, 32), _mm_slli_epi64(merged, 20));
+        merged = _mm_shuffle_epi8(merged, pack_shuf);
+
+        // Store exactly 10 bytes so we never write past decode_len()
+        uint16_t tail = (uint16_t)_mm_extract_epi16(merged, 4);
+        _mm_storel_epi64((__m128i*)(output + out_pos), merged);
+        memcpy(output + out_pos + 8, &tail, sizeof(tail));
+        out_pos += 10;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
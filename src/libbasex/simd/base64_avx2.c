@@ -0,0 +1,112 @@
+// AVX2-optimized Base64 encoding/decoding
+// Based on the Muła/Lemire approach: pshufb reshuffle + multiply-shift to
+// split 24-bit groups, range-based translation between indices and ASCII
+
+#include "simd.h"
+
+#ifdef HAVE_AVX2
+
+#include <immintrin.h>
+
+// Translate 32 6-bit indices to the RFC 4648 alphabet.
+// Indices are bucketed (0-25, 26-51, 52-61, 62, 63) and each bucket
+// gets a constant offset from a 16-entry pshufb table.
+static inline __m256i enc_translate(__m256i indices) {
+    const __m256i shift_lut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+    return _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+}
+
+size_t basex_base64_encode_avx2(const uint8_t* input, size_t input_len, char* output) {
+    // Per 32-bit lane: [b1 b0 b2 b1] so each lane holds one 24-bit group
+    const __m256i shuf = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    size_t i = 0;
+
+    // Each iteration reads 28 bytes (two 16-byte loads at +0 and +12)
+    for (; i + 28 <= input_len; i += 24) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(input + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuf);
+
+        // Extract the four 6-bit fields with multiply-shift
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        _mm256_storeu_si256((__m256i*)(output + (i / 3) * 4), enc_translate(indices));
+    }
+
+    return i;
+}
+
+size_t basex_base64_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len) {
+    // Validation: a byte is invalid iff lut_lo[low nibble] & lut_hi[high nibble] != 0
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    // Offset from ASCII to index, selected by high nibble ('/' special-cased)
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+    const __m256i pack_shuf = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i pack_perm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 32 <= input_len; i += 32) {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(input + i));
+
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) break; // Let the scalar path handle it
+
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        // Pack 4x6 bits -> 24 bits per 32-bit lane, then compact to 24 bytes
+        __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, pack_shuf);
+        merged = _mm256_permutevar8x32_epi32(merged, pack_perm);
+
+        // Store exactly 24 bytes so we never write past decode_len()
+        _mm_storeu_si128((__m128i*)(output + out_pos), _mm256_castsi256_si128(merged));
+        _mm_storel_epi64((__m128i*)(output + out_pos + 16), _mm256_extracti128_si256(merged, 1));
+        out_pos += 24;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
@@ -0,0 +1,90 @@
+// SSSE3/SSE4.1 Base64 encoding/decoding
+// 128-bit version of the AVX2 kernels: 12 bytes <-> 16 characters per
+// iteration
+
+#include "simd.h"
+
+#ifdef HAVE_SSE41
+
+#include <smmintrin.h>
+#include <string.h>
+
+// Translate 16 6-bit indices to the RFC 4648 alphabet (see base64_avx2.c)
+static inline __m128i enc_translate(__m128i indices) {
+    const __m128i shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+}
+
+size_t basex_base64_encode_sse41(const uint8_t* input, size_t input_len, char* output) {
+    const __m128i shuf = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    size_t i = 0;
+
+    // Each iteration reads 16 bytes and consumes 12
+    for (; i + 16 <= input_len; i += 12) {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + i)), shuf);
+
+        __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        _mm_storeu_si128((__m128i*)(output + (i / 3) * 4), enc_translate(indices));
+    }
+
+    return i;
+}
+
+size_t basex_base64_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+    const __m128i pack_shuf = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 16 <= input_len; i += 16) {
+        __m128i str = _mm_loadu_si128((const __m128i*)(input + i));
+
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm_testz_si128(lo, hi)) break; // Let the scalar path handle it
+
+        __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+
+        __m128i merged = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        merged = _mm_shuffle_epi8(merged, pack_shuf);
+
+        // Store exactly 12 bytes so we never write past decode_len()
+        uint32_t tail = (uint32_t)_mm_extract_epi32(merged, 2);
+        _mm_storel_epi64((__m128i*)(output + out_pos), merged);
+        memcpy(output + out_pos + 8, &tail, sizeof(tail));
+        out_pos += 12;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
@@ -1,13 +1,218 @@
-// AVX2-optimized Base85 encoding
-// Placeholder for future SIMD implementation
+// AVX2-optimized Base85 encoding/decoding (RFC 1924)
+// Processes eight 32-bit words (32 bytes <-> 40 characters) per iteration.
+// Divisions by powers of 85 use multiply-high reciprocals and are
+// independent of each other, so there is no serial % 85 / 85 chain.
 
-#include "../../../include/basex.h"
+#include "simd.h"
 
 #ifdef HAVE_AVX2
 
-// TODO: Implement AVX2-optimized Base85 encoding
-// - Use VPSHUFB for table lookups
-// - Process 32 bytes in parallel
-// - Expected speedup: 4-6x over portable version
+#include <immintrin.h>
+#include <string.h>
+
+// Exact unsigned 32-bit division: (v * magic) >> shift, shift >= 32.
+// mul_epu32 only multiplies even lanes, so odd lanes are handled with a
+// second multiply whose result lands directly in the high dword.
+static inline __m256i div_u32(__m256i v, uint32_t magic, int shift) {
+    const __m256i m = _mm256_set1_epi32((int)magic);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(v, m), shift);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), m);
+    odd = _mm256_srli_epi64(odd, shift - 32);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+static inline __m256i mul85(__m256i v) {
+    return _mm256_mullo_epi32(v, _mm256_set1_epi32(85));
+}
+
+// Map digit values 0-84 to the RFC 1924 alphabet.
+// 0-9, A-Z and a-z are contiguous ranges; the 23 punctuation characters
+// come from two 16-entry pshufb tables.
+static inline __m256i enc_translate(__m256i idx) {
+    const __m256i punct_lo = _mm256_setr_epi8(
+        '!', '#', '$', '%', '&', '(', ')', '*', '+', '-', ';', '<', '=', '>', '?', '@',
+        '!', '#', '$', '%', '&', '(', ')', '*', '+', '-', ';', '<', '=', '>', '?', '@');
+    const __m256i punct_hi = _mm256_setr_epi8(
+        '^', '_', '`', '{', '|', '}', '~', 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        '^', '_', '`', '{', '|', '}', '~', 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m256i ge10 = _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(9));
+    __m256i ge36 = _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(35));
+    __m256i ge62 = _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(61));
+
+    __m256i alnum = _mm256_add_epi8(idx, _mm256_set1_epi8('0'));
+    alnum = _mm256_add_epi8(alnum, _mm256_and_si256(ge10, _mm256_set1_epi8('A' - 10 - '0')));
+    alnum = _mm256_add_epi8(alnum, _mm256_and_si256(ge36, _mm256_set1_epi8('a' - 36 - ('A' - 10))));
+
+    __m256i p = _mm256_sub_epi8(idx, _mm256_set1_epi8(62));
+    __m256i punct = _mm256_blendv_epi8(_mm256_shuffle_epi8(punct_lo, p),
+                                       _mm256_shuffle_epi8(punct_hi, p),
+                                       _mm256_cmpgt_epi8(p, _mm256_set1_epi8(15)));
+
+    return _mm256_blendv_epi8(alnum, punct, ge62);
+}
+
+size_t basex_base85_encode_avx2(const uint8_t* input, size_t input_len, char* output) {
+    const __m256i bswap = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    // Interleave four leading digits (dword bytes 0-3) with the last digit
+    // (low byte of each dword of the second vector): 16 + 4 chars per lane
+    const __m256i head_a = _mm256_setr_epi8(
+        0, 1, 2, 3, -1, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12,
+        0, 1, 2, 3, -1, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12);
+    const __m256i head_b = _mm256_setr_epi8(
+        -1, -1, -1, -1, 0, -1, -1, -1, -1, 4, -1, -1, -1, -1, 8, -1,
+        -1, -1, -1, -1, 0, -1, -1, -1, -1, 4, -1, -1, -1, -1, 8, -1);
+    const __m256i tail_a = _mm256_setr_epi8(
+        13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i tail_b = _mm256_setr_epi8(
+        -1, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 32 <= input_len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(input + i));
+        v = _mm256_shuffle_epi8(v, bswap);
+
+        // v / 85^k for k = 1..4
+        __m256i q1 = div_u32(v, 0xC0C0C0C1u, 38);
+        __m256i q2 = div_u32(v, 0x9121B243u, 44);
+        __m256i q3 = div_u32(v, 0xDA8D187Du, 51);
+        __m256i q4 = div_u32(q3, 0xC0C0C0C1u, 38);
+
+        __m256i d0 = q4;
+        __m256i d1 = _mm256_sub_epi32(q3, mul85(q4));
+        __m256i d2 = _mm256_sub_epi32(q2, mul85(q3));
+        __m256i d3 = _mm256_sub_epi32(q1, mul85(q2));
+        __m256i d4 = _mm256_sub_epi32(v, mul85(q1));
+
+        __m256i lead = _mm256_or_si256(
+            _mm256_or_si256(d0, _mm256_slli_epi32(d1, 8)),
+            _mm256_or_si256(_mm256_slli_epi32(d2, 16), _mm256_slli_epi32(d3, 24)));
+        lead = enc_translate(lead);
+        __m256i last = enc_translate(d4);
+
+        __m256i head = _mm256_or_si256(_mm256_shuffle_epi8(lead, head_a),
+                                       _mm256_shuffle_epi8(last, head_b));
+        __m256i tail = _mm256_or_si256(_mm256_shuffle_epi8(lead, tail_a),
+                                       _mm256_shuffle_epi8(last, tail_b));
+        uint32_t tail_lo = (uint32_t)_mm256_extract_epi32(tail, 0);
+        uint32_t tail_hi = (uint32_t)_mm256_extract_epi32(tail, 4);
+
+        _mm_storeu_si128((__m128i*)(output + out_pos), _mm256_castsi256_si128(head));
+        memcpy(output + out_pos + 16, &tail_lo, sizeof(tail_lo));
+        _mm_storeu_si128((__m128i*)(output + out_pos + 20), _mm256_extracti128_si256(head, 1));
+        memcpy(output + out_pos + 36, &tail_hi, sizeof(tail_hi));
+        out_pos += 40;
+    }
+
+    return i;
+}
+
+// Rows 0x20-0x7F of BASE85_DECODE_TABLE, one 16-entry row per high nibble
+static const int8_t DECODE_ROWS[6][16] = {
+    { -1, 62, -1, 63, 64, 65, 66, -1, 67, 68, 69, 70, -1, 71, -1, -1 }, // 0x20
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, 72, 73, 74, 75, 76 }, // 0x30
+    { 77, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 }, // 0x40
+    { 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, 78, 79 }, // 0x50
+    { 80, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50 }, // 0x60
+    { 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 81, 82, 83, 84, -1 }  // 0x70
+};
+
+// Map characters to digit values via an XOR cascade of pshufb lookups:
+// lookup k uses index c - 0x20 - 16k, which is negative (-> 0) for every
+// row above the character's own, so XOR-ing rows pre-XOR-ed with their
+// predecessor leaves exactly the character's row entry.
+// Invalid characters come out with the sign bit set in *bad.
+static inline __m256i dec_translate(__m256i c, const __m256i rows[6], __m256i* bad) {
+    __m256i idx = _mm256_sub_epi8(c, _mm256_set1_epi8(0x20));
+    __m256i digits = _mm256_shuffle_epi8(rows[0], idx);
+    for (int k = 1; k < 6; k++) {
+        idx = _mm256_sub_epi8(idx, _mm256_set1_epi8(0x10));
+        digits = _mm256_xor_si256(digits, _mm256_shuffle_epi8(rows[k], idx));
+    }
+    // Bytes below 0x20 or >= 0x80 never reach a row
+    __m256i outside = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), c);
+    *bad = _mm256_or_si256(*bad, _mm256_or_si256(digits, outside));
+    return digits;
+}
+
+size_t basex_base85_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len) {
+    // Lane layout: A holds chars [0,16) and B chars [4,20) of a 20-char
+    // (4 group) lane. Leading digits of groups 0-2 and the last digits of
+    // groups 0-2 come from A, group 3 from B.
+    const __m256i lead_a = _mm256_setr_epi8(
+        0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1,
+        0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1);
+    const __m256i lead_b = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14);
+    const __m256i last_a = _mm256_setr_epi8(
+        4, -1, -1, -1, 9, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1,
+        4, -1, -1, -1, 9, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i last_b = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, -1);
+    // Fill the unused bytes of the last-digit vector with '0' (digit 0)
+    const __m256i last_fill = _mm256_set1_epi32(0x30303000);
+    const __m256i bswap = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    // 85 * 50529027 == 0xFFFFFFFF
+    const __m256i max_lead = _mm256_set1_epi32(50529027);
+    __m256i rows[6];
+    __m256i prev = _mm256_setzero_si256();
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (int k = 0; k < 6; k++) {
+        __m256i row = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)DECODE_ROWS[k]));
+        rows[k] = _mm256_xor_si256(row, prev);
+        prev = row;
+    }
+
+    for (; i + 40 <= input_len; i += 40) {
+        const char* src = input + i;
+        __m256i a = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)),
+            _mm_loadu_si128((const __m128i*)(src + 20)), 1);
+        __m256i b = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + 4))),
+            _mm_loadu_si128((const __m128i*)(src + 24)), 1);
+
+        __m256i lead = _mm256_or_si256(_mm256_shuffle_epi8(a, lead_a),
+                                       _mm256_shuffle_epi8(b, lead_b));
+        __m256i last = _mm256_or_si256(_mm256_shuffle_epi8(a, last_a),
+                                       _mm256_shuffle_epi8(b, last_b));
+        last = _mm256_or_si256(last, last_fill);
+
+        __m256i bad = _mm256_setzero_si256();
+        lead = dec_translate(lead, rows, &bad);
+        last = dec_translate(last, rows, &bad);
+
+        // Horner: (d0*85 + d1) * 7225 + (d2*85 + d3), then * 85 + d4
+        __m256i hi = _mm256_maddubs_epi16(lead, _mm256_set1_epi16(0x0155));
+        hi = _mm256_madd_epi16(hi, _mm256_set1_epi32(0x00011C39));
+
+        // hi * 85 + d4 > 0xFFFFFFFF  <=>  hi + (d4 != 0) > 50529027
+        __m256i carry = _mm256_min_epu32(last, _mm256_set1_epi32(1));
+        bad = _mm256_or_si256(bad, _mm256_cmpgt_epi32(_mm256_add_epi32(hi, carry), max_lead));
+
+        if (_mm256_movemask_epi8(bad)) {
+            break; // Let the scalar path report the error
+        }
+
+        __m256i value = _mm256_add_epi32(_mm256_mullo_epi32(hi, _mm256_set1_epi32(85)), last);
+        _mm256_storeu_si256((__m256i*)(output + out_pos), _mm256_shuffle_epi8(value, bswap));
+        out_pos += 32;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
 
 #endif
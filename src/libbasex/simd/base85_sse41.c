@@ -0,0 +1,174 @@
+// SSSE3/SSE4.1 Base85 encoding/decoding (RFC 1924)
+// 128-bit version of the AVX2 kernels: four 32-bit words (16 bytes <-> 20
+// characters) per iteration, divisions by powers of 85 via reciprocals
+
+#include "simd.h"
+
+#ifdef HAVE_SSE41
+
+#include <smmintrin.h>
+#include <string.h>
+
+// Exact unsigned 32-bit division: (v * magic) >> shift, shift >= 32
+static inline __m128i div_u32(__m128i v, uint32_t magic, int shift) {
+    const __m128i m = _mm_set1_epi32((int)magic);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(v, m), shift);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(v, 32), m);
+    odd = _mm_srli_epi64(odd, shift - 32);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+static inline __m128i mul85(__m128i v) {
+    return _mm_mullo_epi32(v, _mm_set1_epi32(85));
+}
+
+// Map digit values 0-84 to the RFC 1924 alphabet (see base85_avx2.c)
+static inline __m128i enc_translate(__m128i idx) {
+    const __m128i punct_lo = _mm_setr_epi8(
+        '!', '#', '$', '%', '&', '(', ')', '*', '+', '-', ';', '<', '=', '>', '?', '@');
+    const __m128i punct_hi = _mm_setr_epi8(
+        '^', '_', '`', '{', '|', '}', '~', 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m128i ge10 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(9));
+    __m128i ge36 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(35));
+    __m128i ge62 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(61));
+
+    __m128i alnum = _mm_add_epi8(idx, _mm_set1_epi8('0'));
+    alnum = _mm_add_epi8(alnum, _mm_and_si128(ge10, _mm_set1_epi8('A' - 10 - '0')));
+    alnum = _mm_add_epi8(alnum, _mm_and_si128(ge36, _mm_set1_epi8('a' - 36 - ('A' - 10))));
+
+    __m128i p = _mm_sub_epi8(idx, _mm_set1_epi8(62));
+    __m128i punct = _mm_blendv_epi8(_mm_shuffle_epi8(punct_lo, p),
+                                    _mm_shuffle_epi8(punct_hi, p),
+                                    _mm_cmpgt_epi8(p, _mm_set1_epi8(15)));
+
+    return _mm_blendv_epi8(alnum, punct, ge62);
+}
+
+size_t basex_base85_encode_sse41(const uint8_t* input, size_t input_len, char* output) {
+    const __m128i bswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    // Interleave four leading digits (dword bytes 0-3) with the last digit
+    const __m128i head_a = _mm_setr_epi8(0, 1, 2, 3, -1, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12);
+    const __m128i head_b = _mm_setr_epi8(-1, -1, -1, -1, 0, -1, -1, -1, -1, 4, -1, -1, -1, -1, 8, -1);
+    const __m128i tail_a = _mm_setr_epi8(13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i tail_b = _mm_setr_epi8(-1, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (; i + 16 <= input_len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(input + i));
+        v = _mm_shuffle_epi8(v, bswap);
+
+        // v / 85^k for k = 1..4
+        __m128i q1 = div_u32(v, 0xC0C0C0C1u, 38);
+        __m128i q2 = div_u32(v, 0x9121B243u, 44);
+        __m128i q3 = div_u32(v, 0xDA8D187Du, 51);
+        __m128i q4 = div_u32(q3, 0xC0C0C0C1u, 38);
+
+        __m128i d0 = q4;
+        __m128i d1 = _mm_sub_epi32(q3, mul85(q4));
+        __m128i d2 = _mm_sub_epi32(q2, mul85(q3));
+        __m128i d3 = _mm_sub_epi32(q1, mul85(q2));
+        __m128i d4 = _mm_sub_epi32(v, mul85(q1));
+
+        __m128i lead = _mm_or_si128(
+            _mm_or_si128(d0, _mm_slli_epi32(d1, 8)),
+            _mm_or_si128(_mm_slli_epi32(d2, 16), _mm_slli_epi32(d3, 24)));
+        lead = enc_translate(lead);
+        __m128i last = enc_translate(d4);
+
+        __m128i head = _mm_or_si128(_mm_shuffle_epi8(lead, head_a),
+                                    _mm_shuffle_epi8(last, head_b));
+        __m128i tail = _mm_or_si128(_mm_shuffle_epi8(lead, tail_a),
+                                    _mm_shuffle_epi8(last, tail_b));
+        uint32_t tail_word = (uint32_t)_mm_cvtsi128_si32(tail);
+
+        _mm_storeu_si128((__m128i*)(output + out_pos), head);
+        memcpy(output + out_pos + 16, &tail_word, sizeof(tail_word));
+        out_pos += 20;
+    }
+
+    return i;
+}
+
+// Rows 0x20-0x7F of BASE85_DECODE_TABLE, one 16-entry row per high nibble
+static const int8_t DECODE_ROWS[6][16] = {
+    { -1, 62, -1, 63, 64, 65, 66, -1, 67, 68, 69, 70, -1, 71, -1, -1 }, // 0x20
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, 72, 73, 74, 75, 76 }, // 0x30
+    { 77, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 }, // 0x40
+    { 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, 78, 79 }, // 0x50
+    { 80, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50 }, // 0x60
+    { 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 81, 82, 83, 84, -1 }  // 0x70
+};
+
+// XOR cascade of pshufb lookups (see base85_avx2.c); invalid characters
+// come out with the sign bit set in *bad
+static inline __m128i dec_translate(__m128i c, const __m128i rows[6], __m128i* bad) {
+    __m128i idx = _mm_sub_epi8(c, _mm_set1_epi8(0x20));
+    __m128i digits = _mm_shuffle_epi8(rows[0], idx);
+    for (int k = 1; k < 6; k++) {
+        idx = _mm_sub_epi8(idx, _mm_set1_epi8(0x10));
+        digits = _mm_xor_si128(digits, _mm_shuffle_epi8(rows[k], idx));
+    }
+    __m128i outside = _mm_cmpgt_epi8(_mm_set1_epi8(0x20), c);
+    *bad = _mm_or_si128(*bad, _mm_or_si128(digits, outside));
+    return digits;
+}
+
+size_t basex_base85_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    // A holds chars [0,16) and B chars [4,20) of a 20-char (4 group) block
+    const __m128i lead_a = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1);
+    const __m128i lead_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14);
+    const __m128i last_a = _mm_setr_epi8(4, -1, -1, -1, 9, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i last_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, -1);
+    // Fill the unused bytes of the last-digit vector with '0' (digit 0)
+    const __m128i last_fill = _mm_set1_epi32(0x30303000);
+    const __m128i bswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    // 85 * 50529027 == 0xFFFFFFFF
+    const __m128i max_lead = _mm_set1_epi32(50529027);
+    __m128i rows[6];
+    __m128i prev = _mm_setzero_si128();
+    size_t i = 0;
+    size_t out_pos = 0;
+
+    for (int k = 0; k < 6; k++) {
+        __m128i row = _mm_loadu_si128((const __m128i*)DECODE_ROWS[k]);
+        rows[k] = _mm_xor_si128(row, prev);
+        prev = row;
+    }
+
+    for (; i + 20 <= input_len; i += 20) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(input + i + 4));
+
+        __m128i lead = _mm_or_si128(_mm_shuffle_epi8(a, lead_a), _mm_shuffle_epi8(b, lead_b));
+        __m128i last = _mm_or_si128(_mm_shuffle_epi8(a, last_a), _mm_shuffle_epi8(b, last_b));
+        last = _mm_or_si128(last, last_fill);
+
+        __m128i bad = _mm_setzero_si128();
+        lead = dec_translate(lead, rows, &bad);
+        last = dec_translate(last, rows, &bad);
+
+        // Horner: (d0*85 + d1) * 7225 + (d2*85 + d3), then * 85 + d4
+        __m128i hi = _mm_maddubs_epi16(lead, _mm_set1_epi16(0x0155));
+        hi = _mm_madd_epi16(hi, _mm_set1_epi32(0x00011C39));
+
+        // hi * 85 + d4 > 0xFFFFFFFF  <=>  hi + (d4 != 0) > 50529027
+        __m128i carry = _mm_min_epu32(last, _mm_set1_epi32(1));
+        bad = _mm_or_si128(bad, _mm_cmpgt_epi32(_mm_add_epi32(hi, carry), max_lead));
+
+        if (_mm_movemask_epi8(bad)) {
+            break; // Let the scalar path report the error
+        }
+
+        __m128i value = _mm_add_epi32(_mm_mullo_epi32(hi, _mm_set1_epi32(85)), last);
+        _mm_storeu_si128((__m128i*)(output + out_pos), _mm_shuffle_epi8(value, bswap));
+        out_pos += 16;
+    }
+
+    *output_len = out_pos;
+    return i;
+}
+
+#endif
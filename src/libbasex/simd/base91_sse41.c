@@ -0,0 +1,137 @@
+// SSSE3/SSE4.1 Base91 decoding
+// 128-bit version of the AVX2 kernel. Without variable shifts, pairs are
+// merged by multiplying with 2^width, which is 2^13 or 2^14 for a pair and
+// 2^26..2^28 for two of them.
+
+#include "simd.h"
+
+#ifdef HAVE_SSE41
+
+#include <smmintrin.h>
+#include <string.h>
+
+// Alphabet value per character, one row per high nibble 0x2_..0x7_
+static const int8_t DECODE_ROWS[6][16] = {
+    { -1, 62, -1, 63, 64, 65, 66, -1, 67, 68, 69, 70, 71, 72, 73, 74 }, // 0x20
+    { 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 75, 76, 77, 78, 79, 80 }, // 0x30
+    { 81,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14 }, // 0x40
+    { 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 82, -1, 83, 84, 85 }, // 0x50
+    { 86, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40 }, // 0x60
+    { 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 87, 88, 89, 90, -1 }  // 0x70
+};
+
+// XOR cascade of pshufb lookups (see base85_avx2.c); invalid characters
+// come out with the sign bit set in *bad
+static inline __m128i dec_translate(__m128i c, const __m128i rows[6], __m128i* bad) {
+    __m128i idx = _mm_sub_epi8(c, _mm_set1_epi8(0x20));
+    __m128i values = _mm_shuffle_epi8(rows[0], idx);
+    for (int k = 1; k < 6; k++) {
+        idx = _mm_sub_epi8(idx, _mm_set1_epi8(0x10));
+        values = _mm_xor_si128(values, _mm_shuffle_epi8(rows[k], idx));
+    }
+    __m128i outside = _mm_cmpgt_epi8(_mm_set1_epi8(0x20), c);
+    *bad = _mm_or_si128(*bad, _mm_or_si128(values, outside));
+    return values;
+}
+
+static inline int decode_char(char ch) {
+    uint8_t c = (uint8_t)ch;
+    if (c < 0x20 || c >= 0x80) return -1;
+    return DECODE_ROWS[(c >> 4) - 2][c & 0x0F];
+}
+
+size_t basex_base91_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len) {
+    const __m128i lo32 = _mm_set1_epi32(0xFFFF);
+    const __m128i lo64 = _mm_set1_epi64x(0xFFFFFFFF);
+    __m128i rows[6];
+    __m128i prev = _mm_setzero_si128();
+    uint64_t acc = 0;
+    unsigned bits = 0;
+    size_t i = 0;
+    size_t out_pos = 0;
+    // Last pair boundary with no pending bits; the scalar loop resumes there
+    size_t safe_in = 0;
+    size_t safe_out = 0;
+
+    for (int k = 0; k < 6; k++) {
+        __m128i row = _mm_loadu_si128((const __m128i*)DECODE_ROWS[k]);
+        rows[k] = _mm_xor_si128(row, prev);
+        prev = row;
+    }
+
+    for (; i + 16 <= input_len; i += 16) {
+        __m128i bad = _mm_setzero_si128();
+        __m128i c = dec_translate(_mm_loadu_si128((const __m128i*)(input + i)), rows, &bad);
+        if (_mm_movemask_epi8(bad)) break; // Let the scalar path report the error
+
+        // 8 pair values c0 + 91 * c1, 13 bits wide unless (v & 0x1FFF) <= 88
+        __m128i v = _mm_maddubs_epi16(c, _mm_set1_epi16(0x5B01));
+        __m128i wide = _mm_or_si128(_mm_cmpgt_epi16(_mm_set1_epi16(89), v),
+                                    _mm_cmpgt_epi16(v, _mm_set1_epi16(8191)));
+        __m128i w = _mm_sub_epi16(_mm_set1_epi16(13), wide);
+        __m128i scale = _mm_add_epi16(_mm_set1_epi16(1 << 13),
+                                      _mm_and_si128(wide, _mm_set1_epi16(1 << 13)));
+
+        // Merge pairs of pairs (26-28 bits), then pairs of those (52-56 bits)
+        __m128i d = _mm_or_si128(_mm_and_si128(v, lo32),
+                                 _mm_mullo_epi32(_mm_srli_epi32(v, 16), _mm_and_si128(scale, lo32)));
+        __m128i dw = _mm_add_epi32(_mm_and_si128(w, lo32), _mm_srli_epi32(w, 16));
+
+        __m128i dw_lo = _mm_and_si128(dw, lo64);
+        __m128i dscale = _mm_add_epi32(
+            _mm_add_epi32(_mm_set1_epi32(1 << 26),
+                          _mm_and_si128(_mm_cmpgt_epi32(dw_lo, _mm_set1_epi32(26)), _mm_set1_epi32(1 << 26))),
+            _mm_and_si128(_mm_cmpgt_epi32(dw_lo, _mm_set1_epi32(27)), _mm_set1_epi32(1 << 27)));
+        __m128i q = _mm_or_si128(_mm_and_si128(d, lo64),
+                                 _mm_mul_epu32(_mm_srli_epi64(d, 32), dscale));
+        __m128i qw = _mm_add_epi64(dw_lo, _mm_srli_epi64(dw, 32));
+
+        uint64_t chunks[2];
+        uint64_t widths[2];
+        _mm_storeu_si128((__m128i*)chunks, q);
+        _mm_storeu_si128((__m128i*)widths, qw);
+
+        // Append each chunk behind the pending bits; the 8-byte store may
+        // run past the last complete byte, which the next store overwrites
+        for (int k = 0; k < 2; k++) {
+            uint64_t t = acc | (chunks[k] << bits);
+            unsigned total = bits + (unsigned)widths[k];
+            memcpy(output + out_pos, &t, sizeof(t));
+            out_pos += total >> 3;
+            acc = t >> (total & ~7u);
+            bits = total & 7;
+            if (bits == 0) {
+                safe_in = i + (size_t)(k + 1) * 8;
+                safe_out = out_pos;
+            }
+        }
+    }
+
+    // Walk a few more pairs to reach a byte boundary, so the caller does
+    // not have to pick up pending bits
+    while (bits != 0 && i + 2 <= input_len) {
+        int c0 = decode_char(input[i]);
+        int c1 = decode_char(input[i + 1]);
+        if (c0 < 0 || c1 < 0) break;
+
+        uint32_t value = (uint32_t)(c0 + c1 * 91);
+        acc |= (uint64_t)value << bits;
+        bits += (value & 0x1FFF) > 88 ? 13 : 14;
+        while (bits > 7) {
+            output[out_pos++] = acc & 0xFF;
+            acc >>= 8;
+            bits -= 8;
+        }
+        i += 2;
+        if (bits == 0) {
+            safe_in = i;
+            safe_out = out_pos;
+        }
+    }
+
+    *output_len = safe_out;
+    return safe_in;
+}
+
+#endif
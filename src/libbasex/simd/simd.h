@@ -0,0 +1,92 @@
+// Internal SIMD kernel interface
+// Kernels process whole blocks only and return the number of input bytes
+// consumed (decoders also report bytes written); the portable code in
+// src/libbasex/*.c handles the remainder.
+
+#ifndef BASEX_SIMD_H
+#define BASEX_SIMD_H
+
+#include "../../../include/basex.h"
+
+#ifdef HAVE_BMI
+
+// BMI2 scalar kernels: 5 bytes (Base32) or 7 bytes (Base122) per PDEP,
+// reading 8 bytes at a time
+size_t basex_base32_encode_bmi2(const uint8_t* input, size_t input_len, char* output);
+size_t basex_base122_encode_bmi2(const uint8_t* input, size_t input_len, char* output);
+// Returns at a position where no bits or escape are pending
+size_t basex_base122_decode_bmi2(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+
+#endif
+
+#ifdef HAVE_SSE41
+
+// SSSE3/SSE4.1 tier: 128-bit versions of the AVX2 kernels below
+size_t basex_base32_encode_sse41(const uint8_t* input, size_t input_len, char* output);
+size_t basex_base32_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+size_t basex_base64_encode_sse41(const uint8_t* input, size_t input_len, char* output);
+size_t basex_base64_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+size_t basex_base85_encode_sse41(const uint8_t* input, size_t input_len, char* output);
+size_t basex_base85_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+size_t basex_base91_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+size_t basex_base122_encode_sse41(const uint8_t* input, size_t input_len, char* output);
+size_t basex_base122_decode_sse41(const char* input, size_t input_len, uint8_t* output,
+                                  size_t* output_len);
+
+#endif
+
+#ifdef HAVE_AVX2
+
+// Base32: 20 input bytes -> 32 characters per iteration
+size_t basex_base32_encode_avx2(const uint8_t* input, size_t input_len, char* output);
+// Stops at the first block containing a non-alphabet character (incl. '=')
+size_t basex_base32_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len);
+
+// Base64: 24 input bytes -> 32 characters per iteration
+size_t basex_base64_encode_avx2(const uint8_t* input, size_t input_len, char* output);
+// Stops at the first block containing a non-alphabet character (incl. '=')
+size_t basex_base64_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len);
+
+// Base85: 32 input bytes (eight words) -> 40 characters per iteration
+size_t basex_base85_encode_avx2(const uint8_t* input, size_t input_len, char* output);
+// Stops at the first block with an invalid character or a group > 0xFFFFFFFF
+size_t basex_base85_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len);
+
+// Base91: 32 characters (16 pairs) per iteration; returns at a pair
+// boundary with no pending bits
+size_t basex_base91_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                size_t* output_len);
+
+// Base122: 28 input bytes (four 7-byte blocks) -> 32 characters per iteration
+size_t basex_base122_encode_avx2(const uint8_t* input, size_t input_len, char* output);
+// Returns at a position where no bits or escape are pending
+size_t basex_base122_decode_avx2(const char* input, size_t input_len, uint8_t* output,
+                                 size_t* output_len);
+
+#endif
+
+#ifdef HAVE_AVX512VBMI
+
+// Base32: 40 input bytes -> 64 characters per iteration
+size_t basex_base32_encode_avx512(const uint8_t* input, size_t input_len, char* output);
+// Stops at the first block containing a non-alphabet character (incl. '=')
+size_t basex_base32_decode_avx512(const char* input, size_t input_len, uint8_t* output,
+                                  size_t* output_len);
+
+// Base64: 48 input bytes -> 64 characters per iteration
+size_t basex_base64_encode_avx512(const uint8_t* input, size_t input_len, char* output);
+// Stops at the first block containing a non-alphabet character (incl. '=')
+size_t basex_base64_decode_avx512(const char* input, size_t input_len, uint8_t* output,
+                                  size_t* output_len);
+
+#endif
+
+#endif /* BASEX_SIMD_H */
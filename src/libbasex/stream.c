@@ -0,0 +1,429 @@
+#include "../../include/basex.h"
+#include "parallel.h"
+#include "stream.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Streaming encoding/decoding
+// Block codecs hold back the incomplete block (at most 7 bytes) and run
+// the one-shot functions on whole blocks, so they keep their block
+// kernels. Bit-stream codecs carry their state through the cores in
+// stream.h.
+//
+// Skip modes other than the default run in front of the cores: input is
+// compacted into a small stage in L1, eight bytes per step, and only words
+// holding a byte that may be skipped are looked at byte by byte.
+//
+// Wrapped output is encoded a cache-sized piece at a time and then spread
+// apart in place, from the back, one line per move.
+
+// Input block of a held-back codec, 0 for codecs with a streaming core
+static size_t block_size(const basex_stream_t* stream) {
+    switch (stream->codec) {
+        case BASEX_CODEC_BASE32:  return stream->decode ? 0 : 5;
+        case BASEX_CODEC_BASE64:  return stream->decode ? 0 : 3;
+        case BASEX_CODEC_BASE85:  return stream->decode ? 5 : 4;
+        case BASEX_CODEC_BASE91:  return 0;
+        case BASEX_CODEC_BASE122: return stream->decode ? 0 : 7;
+    }
+    return 0;
+}
+
+// One-shot encode/decode of whole blocks (or the final partial one)
+static ssize_t run_blocks(const basex_stream_t* stream, const uint8_t* input, size_t input_len,
+                          uint8_t* output) {
+    if (input_len == 0) return 0;
+
+    if (stream->decode) {
+        return basex_base85_decode((const char*)input, input_len, output);
+    }
+    switch (stream->codec) {
+        case BASEX_CODEC_BASE32:  return basex_base32_encode(input, input_len, (char*)output);
+        case BASEX_CODEC_BASE64:  return basex_base64_encode(input, input_len, (char*)output);
+        case BASEX_CODEC_BASE85:  return basex_base85_encode(input, input_len, (char*)output);
+        case BASEX_CODEC_BASE122: return basex_base122_encode(input, input_len, (char*)output);
+        default:                  return -1;
+    }
+}
+
+// Class of each input byte under a skip mode
+#define SKIP_DROP 0
+#define SKIP_KEEP 1
+#define SKIP_BAD  2
+#define SKIP_STAGE 16384
+#define WRAP_CHUNK (48 * 1024)
+
+static uint8_t SKIP_CLASS[2][BASEX_CODEC_BASE122 + 1][256];
+static pthread_once_t skip_once = PTHREAD_ONCE_INIT;
+
+static bool is_space(int c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static void init_skip_tables(void) {
+    for (int codec = BASEX_CODEC_BASE32; codec <= BASEX_CODEC_BASE122; codec++) {
+        for (int c = 0; c < 256; c++) {
+            uint8_t* whitespace = &SKIP_CLASS[0][codec][c];
+            uint8_t* garbage = &SKIP_CLASS[1][codec][c];
+            
+            // Other non-alphabet bytes are kept for the cores to reject
+            *whitespace = is_space(c) ? SKIP_DROP : SKIP_KEEP;
+            switch (codec) {
+                case BASEX_CODEC_BASE85:
+                    *garbage = basex_base85_is_symbol((uint8_t)c) ? SKIP_KEEP : SKIP_DROP;
+                    break;
+                case BASEX_CODEC_BASE91:
+                    *garbage = basex_base91_is_symbol((uint8_t)c) ? SKIP_KEEP : SKIP_DROP;
+                    break;
+                case BASEX_CODEC_BASE122:
+                    // Every Base122 byte has the top bit set
+                    if (c < 0x80 && !is_space(c)) *whitespace = SKIP_BAD;
+                    *garbage = c < 0x80 ? SKIP_DROP : SKIP_KEEP;
+                    break;
+                default:
+                    // Unused: the Base32/Base64 cores skip garbage themselves
+                    *garbage = SKIP_KEEP;
+                    break;
+            }
+        }
+    }
+}
+
+// Whether input goes through compact() before the cores
+static bool skip_filtered(const basex_stream_t* stream) {
+    if (!stream->decode || stream->skip == BASEX_SKIP_DEFAULT) return false;
+    return stream->skip == BASEX_SKIP_WHITESPACE ||
+           (stream->codec != BASEX_CODEC_BASE32 && stream->codec != BASEX_CODEC_BASE64);
+}
+
+// Copy input to stage without the skipped bytes, -1 on a rejected byte.
+// Words with no byte that can be skipped are copied whole: for Base122
+// these are words of bytes >= 0x80, otherwise words of bytes > ' '.
+static ssize_t compact(const basex_stream_t* stream, const uint8_t* input, size_t input_len,
+                       uint8_t* stage) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t high = 0x8080808080808080ULL;
+    const uint8_t* class = SKIP_CLASS[stream->skip == BASEX_SKIP_GARBAGE][stream->codec];
+    bool any_byte = stream->skip == BASEX_SKIP_GARBAGE && stream->codec != BASEX_CODEC_BASE122;
+    size_t n = 0;
+    size_t i = 0;
+    uint8_t bad = 0;
+    
+    pthread_once(&skip_once, init_skip_tables);
+    
+    if (!any_byte) {
+        for (; i + 8 <= input_len; i += 8) {
+            uint64_t word;
+            memcpy(&word, input + i, 8);
+            uint64_t suspect = stream->codec == BASEX_CODEC_BASE122
+                ? ~word & high
+                : (word - ones * 0x21) & ~word & high;
+            if (!suspect) {
+                memcpy(stage + n, &word, 8);
+                n += 8;
+                continue;
+            }
+            for (int j = 0; j < 8; j++) {
+                uint8_t c = input[i + j];
+                stage[n] = c;
+                n += class[c] & SKIP_KEEP;
+                bad |= class[c];
+            }
+        }
+    }
+    
+    for (; i < input_len; i++) {
+        uint8_t c = input[i];
+        stage[n] = c;
+        n += class[c] & SKIP_KEEP;
+        bad |= class[c];
+    }
+    
+    return (bad & SKIP_BAD) ? -1 : (ssize_t)n;
+}
+
+// Insert line breaks into len characters at output, which has room for
+// them (see basex_stream_output_len); returns the new length
+static size_t wrap_lines(basex_stream_t* stream, char* output, size_t len) {
+    size_t columns = stream->wrap;
+    size_t breaks = (stream->column + len) / columns;
+    size_t src = len;
+    size_t dst = len + breaks * (stream->crlf ? 2 : 1);
+    size_t total = dst;
+    
+    // Text after the last break, then whole lines; the first partial
+    // line is already in place
+    size_t seg = (stream->column + len) % columns;
+    for (; breaks > 0; breaks--) {
+        src -= seg;
+        dst -= seg;
+        memmove(output + dst, output + src, seg);
+        output[--dst] = '\n';
+        if (stream->crlf) output[--dst] = '\r';
+        seg = columns;
+    }
+    
+    stream->column = (unsigned)((stream->column + len) % columns);
+    return total;
+}
+
+int basex_stream_init(basex_stream_t* stream, basex_codec_t codec, bool decode) {
+    if (!stream || codec < BASEX_CODEC_BASE32 || codec > BASEX_CODEC_BASE122) return -1;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->codec = codec;
+    stream->decode = decode;
+    stream->pending = -1;
+    return 0;
+}
+
+int basex_stream_set_skip(basex_stream_t* stream, basex_skip_t skip) {
+    if (!stream || skip < BASEX_SKIP_DEFAULT || skip > BASEX_SKIP_GARBAGE) return -1;
+    
+    stream->skip = skip;
+    return 0;
+}
+
+int basex_stream_set_wrap(basex_stream_t* stream, unsigned columns, bool crlf) {
+    if (!stream || stream->decode) return -1;
+    
+    stream->wrap = columns;
+    stream->crlf = crlf;
+    stream->column = 0;
+    return 0;
+}
+
+// Encoded length plus room for its line breaks: one more for the line
+// already started, and one ending the last line in the final call
+static size_t with_breaks(const basex_stream_t* stream, size_t len) {
+    if (stream->decode || stream->wrap == 0) return len;
+    return len + (len / stream->wrap + 2) * (stream->crlf ? 2 : 1);
+}
+
+size_t basex_stream_output_len(const basex_stream_t* stream, size_t input_len) {
+    // Held-back input and carried bits add less than one 8-byte block
+    size_t len = input_len + sizeof(stream->carry);
+
+    switch (stream->codec) {
+        case BASEX_CODEC_BASE32:
+            return stream->decode ? basex_base32_decode_len(len)
+                                  : with_breaks(stream, basex_base32_encode_len(len));
+        case BASEX_CODEC_BASE64:
+            return stream->decode ? basex_base64_decode_len(len)
+                                  : with_breaks(stream, basex_base64_encode_len(len));
+        case BASEX_CODEC_BASE85:
+            return stream->decode ? basex_base85_decode_len(len)
+                                  : with_breaks(stream, basex_base85_encode_len(len));
+        case BASEX_CODEC_BASE91:
+            return stream->decode ? basex_base91_decode_len(len)
+                                  : with_breaks(stream, basex_base91_encode_len(len));
+        case BASEX_CODEC_BASE122:
+            return stream->decode ? basex_base122_decode_len(len)
+                                  : with_breaks(stream, basex_base122_encode_len(len));
+    }
+    return 0;
+}
+
+static ssize_t update(basex_stream_t* stream, const void* input, size_t input_len, void* output) {
+    const uint8_t* in = input;
+    uint8_t* out = output;
+    size_t block = block_size(stream);
+
+    if (block == 0) {
+        switch (stream->codec) {
+            case BASEX_CODEC_BASE32:
+                return basex_base32_stream_decode(stream, input, input_len, out);
+            case BASEX_CODEC_BASE64:
+                return basex_base64_stream_decode(stream, input, input_len, out);
+            case BASEX_CODEC_BASE91:
+                return stream->decode
+                    ? basex_base91_stream_decode(stream, input, input_len, out)
+                    : basex_base91_stream_encode(stream, in, input_len, output);
+            case BASEX_CODEC_BASE122:
+                return basex_base122_stream_decode(stream, input, input_len, out);
+            default:
+                return -1;
+        }
+    }
+
+    size_t out_pos = 0;
+
+    // Complete the held-back block first
+    if (stream->carry_len > 0) {
+        size_t take = block - stream->carry_len;
+        if (take > input_len) take = input_len;
+        memcpy(stream->carry + stream->carry_len, in, take);
+        stream->carry_len += take;
+        in += take;
+        input_len -= take;
+        if (stream->carry_len < block) return 0;
+
+        ssize_t result = run_blocks(stream, stream->carry, block, out);
+        if (result < 0) return -1;
+        out_pos = (size_t)result;
+        stream->carry_len = 0;
+    }
+
+    size_t whole = input_len - input_len % block;
+    ssize_t result = run_blocks(stream, in, whole, out + out_pos);
+    if (result < 0) return -1;
+    out_pos += (size_t)result;
+
+    memcpy(stream->carry, in + whole, input_len - whole);
+    stream->carry_len = input_len - whole;
+    return out_pos;
+}
+
+ssize_t basex_stream_update(basex_stream_t* stream, const void* input, size_t input_len,
+                            void* output) {
+    if (!stream || (!input && input_len > 0) || !output) return -1;
+
+    if (!stream->decode && stream->wrap > 0) {
+        const uint8_t* in = input;
+        size_t out_pos = 0;
+
+        while (input_len > 0) {
+            size_t chunk = input_len < WRAP_CHUNK ? input_len : WRAP_CHUNK;
+            char* out = (char*)output + out_pos;
+            ssize_t result = update(stream, in, chunk, out);
+            if (result < 0) return -1;
+            out_pos += wrap_lines(stream, out, (size_t)result);
+            in += chunk;
+            input_len -= chunk;
+        }
+        return out_pos;
+    }
+    if (!skip_filtered(stream)) return update(stream, input, input_len, output);
+
+    const uint8_t* in = input;
+    uint8_t* out = output;
+    uint8_t stage[SKIP_STAGE];
+    size_t out_pos = 0;
+
+    while (input_len > 0) {
+        size_t chunk = input_len < SKIP_STAGE ? input_len : SKIP_STAGE;
+        ssize_t staged = compact(stream, in, chunk, stage);
+        if (staged < 0) return -1;
+
+        ssize_t result = update(stream, stage, (size_t)staged, out + out_pos);
+        if (result < 0) return -1;
+        out_pos += (size_t)result;
+        in += chunk;
+        input_len -= chunk;
+    }
+    return out_pos;
+}
+
+// Whole blocks on several threads
+static ssize_t run_blocks_parallel(const basex_stream_t* stream, const uint8_t* input,
+                                   size_t input_len, uint8_t* output, int threads) {
+    if (input_len == 0) return 0;
+
+    if (stream->decode) {
+        return basex_base85_decode_parallel((const char*)input, input_len, output, threads);
+    }
+    switch (stream->codec) {
+        case BASEX_CODEC_BASE32:  return basex_base32_encode_parallel(input, input_len, (char*)output, threads);
+        case BASEX_CODEC_BASE64:  return basex_base64_encode_parallel(input, input_len, (char*)output, threads);
+        case BASEX_CODEC_BASE85:  return basex_base85_encode_parallel(input, input_len, (char*)output, threads);
+        case BASEX_CODEC_BASE122: return basex_base122_encode_parallel(input, input_len, (char*)output, threads);
+        default:                  return -1;
+    }
+}
+
+ssize_t basex_stream_update_parallel(basex_stream_t* stream, const void* input, size_t input_len,
+                                     void* output, int threads) {
+    if (!stream || (!input && input_len > 0) || !output) return -1;
+
+    // Encode the pieces as one line, then break it up
+    if (!stream->decode && stream->wrap > 0) {
+        unsigned wrap = stream->wrap;
+        stream->wrap = 0;
+        ssize_t result = basex_stream_update_parallel(stream, input, input_len, output, threads);
+        stream->wrap = wrap;
+        return result < 0 ? -1 : (ssize_t)wrap_lines(stream, output, (size_t)result);
+    }
+
+    // Compact everything up front so the pieces split clean input.
+    // Base32/Base64 decoding runs on one thread and keeps its strict check.
+    bool parallel_decode = stream->decode && stream->codec != BASEX_CODEC_BASE32 &&
+                           stream->codec != BASEX_CODEC_BASE64;
+    if (skip_filtered(stream) && parallel_decode && input_len > SKIP_STAGE) {
+        uint8_t* staged = malloc(input_len);
+        if (!staged) return basex_stream_update(stream, input, input_len, output);
+
+        ssize_t result = compact(stream, input, input_len, staged);
+        if (result >= 0) {
+            basex_skip_t skip = stream->skip;
+            stream->skip = BASEX_SKIP_DEFAULT;
+            result = basex_stream_update_parallel(stream, staged, (size_t)result, output, threads);
+            stream->skip = skip;
+        }
+        free(staged);
+        return result;
+    }
+    if (skip_filtered(stream)) return basex_stream_update(stream, input, input_len, output);
+
+    const uint8_t* in = input;
+    uint8_t* out = output;
+    size_t block = block_size(stream);
+
+    if (block == 0) {
+        // Base91/Base122 decoding splits at bit offsets; Base32/Base64
+        // decoding and Base91 encoding carry bits from byte to byte
+        bool split = stream->decode &&
+                     (stream->codec == BASEX_CODEC_BASE91 || stream->codec == BASEX_CODEC_BASE122);
+        return split ? basex_stream_decode_parallel(stream, input, input_len, out, threads)
+                     : basex_stream_update(stream, input, input_len, output);
+    }
+
+    size_t out_pos = 0;
+
+    // Complete the held-back block on this thread
+    if (stream->carry_len > 0) {
+        size_t take = block - stream->carry_len;
+        if (take > input_len) take = input_len;
+        ssize_t result = basex_stream_update(stream, in, take, out);
+        if (result < 0) return -1;
+        out_pos = (size_t)result;
+        in += take;
+        input_len -= take;
+        if (stream->carry_len > 0) return out_pos;
+    }
+
+    size_t whole = input_len - input_len % block;
+    ssize_t result = run_blocks_parallel(stream, in, whole, out + out_pos, threads);
+    if (result < 0) return -1;
+    out_pos += (size_t)result;
+
+    memcpy(stream->carry, in + whole, input_len - whole);
+    stream->carry_len = input_len - whole;
+    return out_pos;
+}
+
+ssize_t basex_stream_final(basex_stream_t* stream, void* output) {
+    if (!stream || !output) return -1;
+
+    ssize_t result = 0;
+
+    if (block_size(stream) > 0) {
+        result = run_blocks(stream, stream->carry, stream->carry_len, output);
+        stream->carry_len = 0;
+    } else if (stream->codec == BASEX_CODEC_BASE91) {
+        result = stream->decode
+            ? (ssize_t)basex_base91_stream_decode_final(stream, output)
+            : (ssize_t)basex_base91_stream_encode_final(stream, output);
+    }
+    // Other decoders drop leftover bits, as the one-shot functions do
+
+    if (result >= 0 && !stream->decode && stream->wrap > 0) {
+        result = (ssize_t)wrap_lines(stream, output, (size_t)result);
+        if (stream->column > 0) {
+            if (stream->crlf) ((char*)output)[result++] = '\r';
+            ((char*)output)[result++] = '\n';
+            stream->column = 0;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+// Streaming cores
+// Codecs whose state is not a whole number of input blocks carry it in
+// basex_stream_t; the one-shot functions run the same cores from a fresh
+// state. Block codecs are streamed in stream.c by holding back the
+// incomplete block instead.
+
+#ifndef BASEX_STREAM_H
+#define BASEX_STREAM_H
+
+#include "../../include/basex.h"
+
+ssize_t basex_base32_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output);
+ssize_t basex_base64_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output);
+
+bool basex_base85_is_symbol(uint8_t c);
+bool basex_base91_is_symbol(uint8_t c);
+
+ssize_t basex_base91_stream_encode(basex_stream_t* stream, const uint8_t* input, size_t input_len,
+                                   char* output);
+size_t basex_base91_stream_encode_final(basex_stream_t* stream, char* output);
+ssize_t basex_base91_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                   uint8_t* output);
+size_t basex_base91_stream_decode_final(basex_stream_t* stream, uint8_t* output);
+
+ssize_t basex_base122_stream_decode(basex_stream_t* stream, const char* input, size_t input_len,
+                                    uint8_t* output);
+
+#endif /* BASEX_STREAM_H */
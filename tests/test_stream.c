@@ -0,0 +1,225 @@
+// Streaming must give the same output as the one-shot codecs however the
+// input is split: every split point of short inputs, random chunk sizes
+// for longer ones, and large chunks through basex_stream_update_parallel.
+
+#include "../include/basex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    basex_codec_t codec;
+    const char* name;
+    size_t (*encode_len)(size_t);
+    size_t (*decode_len)(size_t);
+    ssize_t (*encode)(const uint8_t*, size_t, char*);
+    ssize_t (*decode)(const char*, size_t, uint8_t*);
+} codec_t;
+
+static const codec_t CODECS[] = {
+    {BASEX_CODEC_BASE32, "base32", basex_base32_encode_len, basex_base32_decode_len,
+     basex_base32_encode, basex_base32_decode},
+    {BASEX_CODEC_BASE64, "base64", basex_base64_encode_len, basex_base64_decode_len,
+     basex_base64_encode, basex_base64_decode},
+    {BASEX_CODEC_BASE85, "base85", basex_base85_encode_len, basex_base85_decode_len,
+     basex_base85_encode, basex_base85_decode},
+    {BASEX_CODEC_BASE91, "base91", basex_base91_encode_len, basex_base91_decode_len,
+     basex_base91_encode, basex_base91_decode},
+    {BASEX_CODEC_BASE122, "base122", basex_base122_encode_len, basex_base122_decode_len,
+     basex_base122_encode, basex_base122_decode},
+};
+#define NUM_CODECS (sizeof(CODECS) / sizeof(CODECS[0]))
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+static int failures = 0;
+
+static uint64_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Uniform bytes, or bytes Base122 has to escape and runs Base85/Base91
+// pack differently, so escape and accumulator state crosses chunk edges
+static void fill(uint8_t* data, size_t len) {
+    static const uint8_t awkward[] = {0, 0, 0, '\n', '\r', '"', '&', '\\', 0x7f, 0xc2, 0xff};
+    bool uniform = rng() & 1;
+    for (size_t i = 0; i < len; i++) {
+        uint64_t r = rng();
+        data[i] = uniform ? (uint8_t)r : awkward[(r >> 8) % sizeof(awkward)];
+    }
+}
+
+// Run input through a stream in the given pieces, with basex_stream_update
+// when threads < 0; -1 on a stream error or when the output outgrows capacity
+static ssize_t run_stream(const codec_t* c, bool decode, const uint8_t* input,
+                          const size_t* pieces, size_t count, int threads,
+                          uint8_t* output, size_t capacity) {
+    basex_stream_t stream;
+    if (basex_stream_init(&stream, c->codec, decode) < 0) return -1;
+    
+    size_t largest = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pieces[i] > largest) largest = pieces[i];
+    }
+    uint8_t* scratch = malloc(basex_stream_output_len(&stream, largest) + 1);
+    if (!scratch) return -1;
+    
+    size_t pos = 0;
+    size_t total = 0;
+    ssize_t result = 0;
+    for (size_t i = 0; i <= count && result >= 0; i++) {
+        if (i < count) {
+            result = threads >= 0 ? basex_stream_update_parallel(&stream, input + pos, pieces[i], scratch, threads)
+                             : basex_stream_update(&stream, input + pos, pieces[i], scratch);
+            pos += pieces[i];
+        } else {
+            result = basex_stream_final(&stream, scratch);
+        }
+        if (result < 0) break;
+        if (total + (size_t)result > capacity) {
+            result = -1;
+            break;
+        }
+        memcpy(output + total, scratch, (size_t)result);
+        total += (size_t)result;
+    }
+    free(scratch);
+    return result < 0 ? -1 : (ssize_t)total;
+}
+
+// Compare one split of one input, both directions, against the one-shot calls
+static void check(const codec_t* c, const uint8_t* data, size_t len,
+                  const size_t* pieces, size_t count, int threads) {
+    size_t text_cap = c->encode_len(len) + 1;
+    char* text = malloc(text_cap);
+    uint8_t* streamed = malloc(text_cap + 64);
+    ssize_t text_len = c->encode(data, len, text);
+    
+    ssize_t got = run_stream(c, false, data, pieces, count, threads, streamed, text_cap + 64);
+    if (text_len < 0 || got != text_len || memcmp(text, streamed, (size_t)got) != 0) {
+        fprintf(stderr, "%s: encode of %zu bytes in %zu pieces (threads %d) differs\n",
+                c->name, len, count, threads);
+        failures++;
+        free(streamed);
+        free(text);
+        return;
+    }
+    
+    // Split the text at the same relative points
+    size_t data_cap = c->decode_len((size_t)text_len) + 1;
+    uint8_t* plain = malloc(data_cap);
+    free(streamed);
+    streamed = malloc(data_cap + 64);
+    ssize_t plain_len = c->decode(text, (size_t)text_len, plain);
+    size_t* text_pieces = malloc((count + 1) * sizeof(size_t));
+    size_t used = 0;
+    size_t prev = 0;
+    for (size_t i = 0; i < count; i++) {
+        used += pieces[i];
+        size_t end = i + 1 == count || len == 0
+            ? (size_t)text_len
+            : (size_t)((unsigned long long)used * (size_t)text_len / len);
+        text_pieces[i] = end - prev;
+        prev = end;
+    }
+    
+    got = run_stream(c, true, (const uint8_t*)text, text_pieces, count,
+                     threads, streamed, data_cap + 64);
+    if (got != plain_len || (got > 0 && memcmp(plain, streamed, (size_t)got) != 0)) {
+        fprintf(stderr, "%s: decode of %zd characters in %zu pieces (threads %d) differs\n",
+                c->name, text_len, count, threads);
+        failures++;
+    }
+    
+    free(text_pieces);
+    free(plain);
+    free(streamed);
+    free(text);
+}
+
+// Decode the encoding of data split into two pieces at every character
+static void check_decode_splits(const codec_t* c, const uint8_t* data, size_t len) {
+    char* text = malloc(c->encode_len(len) + 1);
+    ssize_t text_len = c->encode(data, len, text);
+    size_t data_cap = c->decode_len((size_t)text_len) + 1;
+    uint8_t* plain = malloc(data_cap);
+    uint8_t* streamed = malloc(data_cap + 64);
+    ssize_t plain_len = c->decode(text, (size_t)text_len, plain);
+    
+    for (size_t split = 0; text_len >= 0 && split <= (size_t)text_len; split++) {
+        size_t pieces[2] = {split, (size_t)text_len - split};
+        ssize_t got = run_stream(c, true, (const uint8_t*)text, pieces, 2, -1,
+                                 streamed, data_cap + 64);
+        if (got != plain_len || (got > 0 && memcmp(plain, streamed, (size_t)got) != 0)) {
+            fprintf(stderr, "%s: decode of %zd characters split at %zu differs\n",
+                    c->name, text_len, split);
+            failures++;
+        }
+    }
+    
+    free(streamed);
+    free(plain);
+    free(text);
+}
+
+int main(void) {
+    uint8_t* data = malloc(3 << 20);
+    size_t pieces[4096];
+    
+    for (size_t k = 0; k < NUM_CODECS; k++) {
+        const codec_t* c = &CODECS[k];
+        
+        // Every split point into two pieces
+        for (size_t len = 0; len <= 48; len++) {
+            fill(data, len);
+            for (size_t split = 0; split <= len; split++) {
+                pieces[0] = split;
+                pieces[1] = len - split;
+                check(c, data, len, pieces, 2, -1);
+            }
+            check_decode_splits(c, data, len);
+        }
+        
+        // Random pieces of 1..max bytes
+        static const size_t max_piece[] = {1, 3, 17, 100, 1500};
+        for (int round = 0; round < 200; round++) {
+            size_t len = (size_t)(rng() % 4000);
+            size_t max = max_piece[round % 5];
+            size_t count = 0;
+            fill(data, len);
+            for (size_t pos = 0; pos < len && count < 4096; count++) {
+                size_t n = 1 + (size_t)(rng() % max);
+                if (n > len - pos) n = len - pos;
+                pieces[count] = n;
+                pos += n;
+            }
+            if (count < 4096) check(c, data, len, pieces, count, -1);
+        }
+        
+        // Pieces large enough to be split across threads, and the same
+        // sizes on one thread
+        static const int threads[] = {-1, 4, 0};
+        for (int round = 0; round < 3; round++) {
+            size_t len = (1 << 20) + (size_t)(rng() % (2 << 20));
+            size_t count = 0;
+            fill(data, len);
+            for (size_t pos = 0; pos < len; count++) {
+                size_t n = 1 + (size_t)(rng() % (1536 * 1024));
+                if (n > len - pos) n = len - pos;
+                pieces[count] = n;
+                pos += n;
+            }
+            check(c, data, len, pieces, count, threads[round]);
+        }
+    }
+    
+    free(data);
+    if (failures) {
+        fprintf(stderr, "%d stream checks failed\n", failures);
+        return 1;
+    }
+    printf("All stream checks passed\n");
+    return 0;
+}